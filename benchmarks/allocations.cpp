@@ -0,0 +1,28 @@
+#include "allocations.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace {
+    thread_local size_t allocation_count = 0;
+}
+
+auto bench::allocations() -> size_t {
+    return allocation_count;
+}
+
+auto operator new(size_t size) -> void* {
+    ++allocation_count;
+    if (auto* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc { };
+}
+
+auto operator delete(void* p) noexcept -> void {
+    std::free(p);
+}
+
+auto operator delete(void* p, size_t) noexcept -> void {
+    std::free(p);
+}
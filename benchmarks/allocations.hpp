@@ -0,0 +1,12 @@
+#ifndef VARIANT_BENCHMARKS_ALLOCATIONS_HPP_INCLUDED
+#define VARIANT_BENCHMARKS_ALLOCATIONS_HPP_INCLUDED
+
+#include <cstddef>
+
+namespace bench {
+
+    // The number of global `operator new` calls made by this thread so far.
+    auto allocations() -> size_t;
+}
+
+#endif //VARIANT_BENCHMARKS_ALLOCATIONS_HPP_INCLUDED
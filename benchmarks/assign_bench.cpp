@@ -0,0 +1,146 @@
+#include "benchmarks.hpp"
+#include "allocations.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include <array>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <variant>
+#define VARIANT_BENCH_HAS_STD_VARIANT 1
+#endif
+
+namespace {
+
+    constexpr size_t iterations = 1 << 18;
+
+    template<typename F>
+    auto run_counted(std::string const& name, F&& f) -> void {
+        auto before = bench::allocations();
+        bench::run(name, iterations, f);
+        auto per_op = 
+            static_cast<double>(bench::allocations() - before) / 
+                (iterations + 1);
+        std::cout << "    " << per_op << " allocations/assign\n";
+    }
+
+    template<typename T>
+    auto assign_benchmark(std::string const& type_name, T const& value) 
+        -> void 
+    {
+        using MyVariant = variant::Variant<int, T>;
+        MyVariant v { value };
+        MyVariant const other { value };
+
+        run_counted("Variant = " + type_name, [&] {
+            v = value;
+            bench::do_not_optimize(v);
+        });
+
+        run_counted("Variant = Variant<" + type_name + ">", [&] {
+            v = other;
+            bench::do_not_optimize(v);
+        });
+
+        // Destroy and reconstruct in place, as assignment did before it 
+        // reused the active alternative. `emplace` never builds through a 
+        // temporary, whatever the strategy.
+        run_counted("Variant::emplace<" + type_name + ">", [&] {
+            v.template emplace<T>(value);
+            bench::do_not_optimize(v);
+        });
+
+#ifdef VARIANT_BENCH_HAS_STD_VARIANT
+        std::variant<int, T> sv { value };
+        run_counted("std::variant = " + type_name, [&] {
+            sv = value;
+            bench::do_not_optimize(sv);
+        });
+#endif
+    }
+}
+
+namespace {
+
+    // A small alternative to switch away from and back to, one per
+    // assignment strategy so that each can be chosen separately.
+    template<variant::AssignStrategy S>
+    struct Small {
+        int value;
+    };
+
+    // Expensive to move as well as to copy, so building it in a
+    // temporary costs more than a pointer swap.
+    struct Record {
+        std::string name;
+        std::array<char, 240> data;
+    };
+}
+
+namespace variant {
+    template<AssignStrategy S, typename T>
+    struct variant_assign_strategy<Small<S>, T> : assign_strategy_t<S> { };
+}
+
+namespace {
+
+    template<variant::AssignStrategy S, typename T>
+    auto strategy_benchmark(std::string const& strategy,
+                            std::string const& type_name,
+                            T const& value)
+        -> void
+    {
+        using MyVariant = variant::Variant<Small<S>, T>;
+        MyVariant v { Small<S> { 0 } };
+        MyVariant const other { value };
+
+        // Each pass replaces the small alternative with a copy of `value`,
+        // which may throw, so the strategy applies, then switches back.
+        run_counted(strategy + " = " + type_name, [&] {
+            v = value;
+            v = Small<S> { 1 };
+            bench::do_not_optimize(v);
+        });
+
+        run_counted(strategy + " = Variant<" + type_name + ">", [&] {
+            v = other;
+            v = Small<S> { 1 };
+            bench::do_not_optimize(v);
+        });
+
+        // In place under `Direct` and `Temporary`, in the spare buffer 
+        // under `DoubleBuffer`.
+        run_counted(strategy + " emplace<" + type_name + ">", [&] {
+            v.template emplace<T>(value);
+            v = Small<S> { 1 };
+            bench::do_not_optimize(v);
+        });
+
+        std::cout << "    " << sizeof(MyVariant) << " bytes\n";
+    }
+
+    template<typename T>
+    auto strategy_benchmarks(std::string const& type_name, T const& value)
+        -> void
+    {
+        using variant::AssignStrategy;
+        strategy_benchmark<AssignStrategy::Direct>(
+            "Direct", type_name, value);
+        strategy_benchmark<AssignStrategy::Temporary>(
+            "Temporary", type_name, value);
+        strategy_benchmark<AssignStrategy::DoubleBuffer>(
+            "DoubleBuffer", type_name, value);
+    }
+}
+
+auto assign_benchmarks() -> void {
+    assign_benchmark<std::string>("std::string", std::string(64, 'x'));
+    assign_benchmark<std::vector<int>>(
+        "std::vector<int>", std::vector<int>(64, 42));
+
+    strategy_benchmarks<std::string>("std::string", std::string(64, 'x'));
+    strategy_benchmarks<Record>(
+        "Record", Record { std::string(64, 'x'), { } });
+}
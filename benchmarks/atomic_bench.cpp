@@ -0,0 +1,164 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/atomic.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    struct Idle { };
+
+    struct Running {
+        std::int32_t progress;
+    };
+
+    struct Failed {
+        std::int32_t code;
+    };
+
+    struct Reading {
+        double value;
+    };
+
+    // 8 bytes: fits a single native atomic
+    using State = variant::Variant<Idle, Running, Failed>;
+
+    // 16 bytes: needs a double word compare-and-swap, or a lock
+    using Sample = variant::Variant<Idle, Reading, Failed>;
+
+    struct Weight {
+        auto operator()(Idle const&) const -> std::int64_t { return 0; }
+        auto operator()(Running const& r) const -> std::int64_t {
+            return r.progress;
+        }
+        auto operator()(Failed const& f) const -> std::int64_t {
+            return -f.code;
+        }
+        auto operator()(Reading const& r) const -> std::int64_t {
+            return static_cast<std::int64_t>(r.value);
+        }
+    };
+
+    auto make_state(std::int32_t i) -> State {
+        return i % 4 == 0 ? State { Failed { i } } : State { Running { i } };
+    }
+
+    auto make_sample(std::int32_t i) -> Sample {
+        return i % 4 == 0
+            ? Sample { Failed { i } }
+            : Sample { Reading { static_cast<double>(i) } };
+    }
+
+    // The baseline: a plain `Variant` behind a mutex.
+    template<typename V>
+    struct Locked {
+        using value_type = V;
+
+        explicit Locked(V const& initial) :
+            value_ { initial }
+        { }
+
+        auto load() const -> V {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            return value_;
+        }
+
+        auto store(V const& val) -> void {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            value_ = val;
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        V value_;
+    };
+
+    // `readers` threads each load and visit `loads` times while one writer
+    // stores continuously, reporting the wall time per load across all
+    // the readers.
+    template<typename A, typename Make>
+    auto contend(std::string const& name,
+                 unsigned readers,
+                 Make make) -> void
+    {
+        constexpr size_t iterations = 5;
+        constexpr size_t loads = 200000;
+
+        A shared { make(1) };
+        auto const ns = bench::run(
+            name + " (" + std::to_string(readers) + " readers)",
+            iterations,
+            [&] {
+                std::atomic<bool> done { false };
+                std::thread writer { [&] {
+                    std::int32_t i = 0;
+                    while (!done.load(std::memory_order_relaxed)) {
+                        shared.store(make(++i));
+                    }
+                } };
+
+                std::vector<std::thread> threads;
+                for (unsigned r = 0; r < readers; ++r) {
+                    threads.emplace_back([&] {
+                        std::int64_t sum = 0;
+                        for (size_t i = 0; i < loads; ++i) {
+                            sum += shared.load().visit(Weight { });
+                        }
+                        bench::do_not_optimize(sum);
+                    });
+                }
+
+                for (auto& t : threads) {
+                    t.join();
+                }
+                done.store(true, std::memory_order_relaxed);
+                writer.join();
+            });
+
+        std::cout << "    " << ns / static_cast<double>(loads * readers)
+                  << " ns/load\n";
+    }
+
+    template<variant::AtomicStrategy S, typename V>
+    struct atomic_of;
+
+    template<variant::AtomicStrategy S, typename... Ts>
+    struct atomic_of<S, variant::Variant<Ts...>> {
+        using type = variant::BasicAtomicVariant<S, Ts...>;
+    };
+
+    template<variant::AtomicStrategy S, typename V>
+    using atomic_of_t = typename atomic_of<S, V>::type;
+}
+
+auto atomic_benchmarks() -> void {
+    using variant::AtomicStrategy;
+
+    auto const cores = std::max(std::thread::hardware_concurrency(), 1u);
+    auto const max_readers = std::max(cores, 4u);
+    std::cout << "one writer against 1.." << max_readers << " readers, "
+              << cores << " hardware threads\n";
+
+    for (unsigned readers = 1; readers <= max_readers; readers *= 2) {
+        contend<atomic_of_t<AtomicStrategy::Word, State>>(
+            "8 byte Word", readers, make_state);
+        contend<atomic_of_t<AtomicStrategy::SeqLock, State>>(
+            "8 byte SeqLock", readers, make_state);
+        contend<Locked<State>>(
+            "8 byte mutex", readers, make_state);
+#ifdef VARIANT_HAS_DOUBLE_WORD_CAS
+        contend<atomic_of_t<AtomicStrategy::DoubleWord, Sample>>(
+            "16 byte DoubleWord", readers, make_sample);
+#endif
+        contend<atomic_of_t<AtomicStrategy::SeqLock, Sample>>(
+            "16 byte SeqLock", readers, make_sample);
+        contend<Locked<Sample>>(
+            "16 byte mutex", readers, make_sample);
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef VARIANT_BENCHMARKS_BENCH_HPP_INCLUDED
+#define VARIANT_BENCHMARKS_BENCH_HPP_INCLUDED
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+    // Stops the optimiser from discarding a value that is otherwise unused.
+    template<typename T>
+    inline auto do_not_optimize(T const& val) -> void {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(val) : "memory");
+#else
+        static volatile char sink;
+        sink = *reinterpret_cast<char const volatile*>(&val);
+#endif
+    }
+
+    inline auto clobber_memory() -> void {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#endif
+    }
+
+    struct Result {
+        std::string name;
+        size_t iterations;
+        double ns_per_iter;
+    };
+
+    // Every measurement taken so far, in order, for the machine-readable
+    // reports.
+    inline auto results() -> std::vector<Result>& {
+        static std::vector<Result> all;
+        return all;
+    }
+
+    // Runs `f` `iterations` times, after one warm-up pass, and reports the
+    // mean time per iteration.
+    template<typename F>
+    auto run(std::string const& name, size_t iterations, F&& f) -> double {
+        using Clock = std::chrono::steady_clock;
+
+        f();
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            f();
+        }
+        auto elapsed = Clock::now() - start;
+
+        auto ns_per_iter = 
+            std::chrono::duration<double, std::nano> { elapsed }.count() /
+                static_cast<double>(iterations);
+
+        std::cout << std::left << std::setw(48) << name 
+                  << std::right << std::setw(14) << std::fixed 
+                  << std::setprecision(2) << ns_per_iter << " ns/iter\n";
+
+        results().push_back({ name, iterations, ns_per_iter });
+        return ns_per_iter;
+    }
+
+    // Cheap deterministic generator so every run sees the same inputs.
+    struct Xorshift {
+        explicit Xorshift(unsigned long long seed = 0x9e3779b97f4a7c15ull) :
+            state_ { seed }
+        { }
+
+        auto operator()() -> unsigned long long {
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 7;
+            state_ ^= state_ << 17;
+            return state_;
+        }
+
+    private:
+        unsigned long long state_;
+    };
+}
+
+#endif //VARIANT_BENCHMARKS_BENCH_HPP_INCLUDED
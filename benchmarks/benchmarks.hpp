@@ -0,0 +1,23 @@
+#ifndef VARIANT_BENCHMARKS_BENCHMARKS_HPP_INCLUDED
+#define VARIANT_BENCHMARKS_BENCHMARKS_HPP_INCLUDED
+
+auto visit_benchmarks() -> void;
+auto multi_visit_benchmarks() -> void;
+auto operations_benchmarks() -> void;
+auto assign_benchmarks() -> void;
+auto variant_vector_benchmarks() -> void;
+auto visit_each_benchmarks() -> void;
+auto parallel_benchmarks() -> void;
+auto comparison_benchmarks() -> void;
+auto recursive_benchmarks() -> void;
+auto json_parse_benchmarks() -> void;
+auto json_write_benchmarks() -> void;
+auto json_object_benchmarks() -> void;
+auto boxed_benchmarks() -> void;
+auto serialize_benchmarks() -> void;
+auto view_benchmarks() -> void;
+auto atomic_benchmarks() -> void;
+auto instrumentation_benchmarks() -> void;
+auto hinted_visit_benchmarks() -> void;
+
+#endif //VARIANT_BENCHMARKS_BENCHMARKS_HPP_INCLUDED
@@ -0,0 +1,95 @@
+#include "benchmarks.hpp"
+#include "allocations.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // A rarely held alternative that would otherwise set the size of
+    // every variant.
+    struct Large {
+        explicit Large(long v) :
+            values { }
+        {
+            values[0] = v;
+        }
+
+        long values[32];
+    };
+
+    struct SumVisitor {
+        auto operator()(long v) const -> long { return v; }
+        auto operator()(double v) const -> long { return static_cast<long>(v); }
+        auto operator()(Large const& l) const -> long { return l.values[0]; }
+    };
+
+    using Inline = variant::Variant<long, double, Large>;
+    using Boxed = variant::CompactVariant<16, long, double, Large>;
+
+    // One value in `rare_per_1000` is a `Large`; the rest are split
+    // between the small alternatives.
+    template<typename V>
+    auto build(size_t count, unsigned rare_per_1000) -> std::vector<V> {
+        bench::Xorshift rng;
+        std::vector<V> values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto const r = rng();
+            auto const n = static_cast<long>(r % 100);
+            if (r % 1000 < rare_per_1000) {
+                values.emplace_back(Large { n });
+            }
+            else if (r & 1024) {
+                values.emplace_back(n);
+            }
+            else {
+                values.emplace_back(static_cast<double>(n));
+            }
+        }
+
+        return values;
+    }
+
+    template<typename V>
+    auto run_distribution(std::string const& name,
+                          size_t count,
+                          unsigned rare_per_1000) -> void
+    {
+        constexpr size_t iterations = 20;
+        auto const suffix = " (" + name + ", " +
+            std::to_string(rare_per_1000 / 10) + "." +
+            std::to_string(rare_per_1000 % 10) + "% large)";
+
+        auto const before = bench::allocations();
+        auto const values = build<V>(count, rare_per_1000);
+        // One allocation is the vector itself; the rest are boxes.
+        auto const boxes = bench::allocations() - before - 1;
+        std::cout << "    " << name << ": " << sizeof(V) << " bytes each, "
+                  << (count * sizeof(V) + boxes * sizeof(Large)) / 1024
+                  << " KiB in total\n";
+
+        bench::run("boxed build" + suffix, iterations, [&] {
+            auto built = build<V>(count, rare_per_1000);
+            bench::do_not_optimize(built.data());
+        });
+
+        bench::run("boxed visit" + suffix, iterations, [&] {
+            long sum = 0;
+            for (auto const& v : values) {
+                sum += v.visit(SumVisitor { });
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+}
+
+auto boxed_benchmarks() -> void {
+    constexpr size_t count = 1 << 16;
+    for (unsigned rare : { 0u, 10u, 100u, 500u }) {
+        run_distribution<Inline>("inline", count, rare);
+        run_distribution<Boxed>("boxed", count, rare);
+    }
+}
@@ -0,0 +1,174 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <variant>
+#define VARIANT_BENCH_HAS_STD_VARIANT 1
+#endif
+
+namespace {
+
+    // What a caller had to write before `Variant` was hashable: one visit 
+    // for the value, then the tag mixed in separately.
+    struct VisitorHash {
+        template<typename V>
+        auto operator()(V const& v) const -> size_t {
+            auto h = v.visit([](auto const& val) { 
+                return std::hash<std::decay_t<decltype(val)>> { }(val); 
+            });
+            return variant::hash_combine(h, v.index());
+        }
+    };
+
+    // ...and one visit per side to compare them.
+    struct VisitorEqual {
+        template<typename V>
+        auto operator()(V const& lhs, V const& rhs) const -> bool {
+            if (lhs.index() != rhs.index()) {
+                return false;
+            }
+
+            return lhs.visit([&rhs](auto const& l) {
+                using T = std::decay_t<decltype(l)>;
+                return l == rhs.template unsafe_get<T>();
+            });
+        }
+    };
+
+    template<typename Key, typename Map>
+    auto lookup_benchmark(std::string const& name, 
+                          std::vector<Key> const& keys, 
+                          Map const& map) 
+        -> void 
+    {
+        constexpr size_t iterations = 50;
+        bench::run(name, iterations, [&] {
+            size_t found = 0;
+            for (auto const& k : keys) {
+                found += map.count(k);
+            }
+            bench::do_not_optimize(found);
+        });
+    }
+
+    template<typename Key, typename Make>
+    auto map_benchmarks(std::string const& label, Make make) -> void {
+        constexpr size_t count = 1 << 14;
+
+        bench::Xorshift rng;
+        std::vector<Key> keys;
+        keys.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            keys.push_back(make(rng()));
+        }
+
+        // Each map is filled separately so that their nodes aren't 
+        // interleaved in memory.
+        std::unordered_map<Key, size_t, VisitorHash, VisitorEqual> visited;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            visited.emplace(keys[i], i);
+        }
+
+        std::unordered_map<Key, size_t> hashed;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            hashed.emplace(keys[i], i);
+        }
+
+        std::map<Key, size_t> ordered;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            ordered.emplace(keys[i], i);
+        }
+
+        constexpr size_t iterations = 200;
+        bench::run("visitor hash" + label, iterations, [&] {
+            size_t h = 0;
+            for (auto const& k : keys) {
+                h += VisitorHash { }(k);
+            }
+            bench::do_not_optimize(h);
+        });
+
+        bench::run("std::hash" + label, iterations, [&] {
+            size_t h = 0;
+            for (auto const& k : keys) {
+                h += std::hash<Key> { }(k);
+            }
+            bench::do_not_optimize(h);
+        });
+
+        bench::run("visitor equality" + label, iterations, [&] {
+            size_t equal = 0;
+            for (size_t i = 1; i < keys.size(); ++i) {
+                equal += VisitorEqual { }(keys[i - 1], keys[i]);
+                equal += VisitorEqual { }(keys[i], keys[keys.size() - i]);
+            }
+            bench::do_not_optimize(equal);
+        });
+
+        bench::run("operator==" + label, iterations, [&] {
+            size_t equal = 0;
+            for (size_t i = 1; i < keys.size(); ++i) {
+                equal += keys[i - 1] == keys[i];
+                equal += keys[i] == keys[keys.size() - i];
+            }
+            bench::do_not_optimize(equal);
+        });
+
+        lookup_benchmark(
+            "unordered_map lookup, visitor hash" + label, keys, visited);
+        lookup_benchmark(
+            "unordered_map lookup, std::hash" + label, keys, hashed);
+        lookup_benchmark("map lookup, operator<" + label, keys, ordered);
+    }
+}
+
+auto comparison_benchmarks() -> void {
+    using Integral = variant::Variant<int, long long, unsigned, char>;
+    map_benchmarks<Integral>(" (integral)", [](unsigned long long r) {
+        switch (r % 4) {
+        case 0: return Integral { static_cast<int>(r >> 32) };
+        case 1: return Integral { static_cast<long long>(r >> 16) };
+        case 2: return Integral { static_cast<unsigned>(r >> 40) };
+        default: return Integral { static_cast<char>(r >> 56) };
+        }
+    });
+
+    using Mixed = variant::Variant<int, std::string>;
+    map_benchmarks<Mixed>(" (int/string)", [](unsigned long long r) {
+        if (r % 2) {
+            return Mixed { static_cast<int>(r >> 32) };
+        }
+        return Mixed { std::to_string(r >> 24) };
+    });
+
+#ifdef VARIANT_BENCH_HAS_STD_VARIANT
+    constexpr size_t count = 1 << 14;
+    using StdIntegral = std::variant<int, long long, unsigned, char>;
+
+    bench::Xorshift rng;
+    std::vector<StdIntegral> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto r = rng();
+        switch (r % 4) {
+        case 0: keys.emplace_back(static_cast<int>(r >> 32)); break;
+        case 1: keys.emplace_back(static_cast<long long>(r >> 16)); break;
+        case 2: keys.emplace_back(static_cast<unsigned>(r >> 40)); break;
+        default: keys.emplace_back(static_cast<char>(r >> 56)); break;
+        }
+    }
+
+    std::unordered_map<StdIntegral, size_t> hashed;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        hashed.emplace(keys[i], i);
+    }
+    lookup_benchmark(
+        "unordered_map lookup, std::variant (integral)", keys, hashed);
+#endif
+}
@@ -0,0 +1,142 @@
+// Measures how long the compiler takes, and how much memory it needs, to
+// build a translation unit that uses a `Variant` of many alternatives.
+// Each run generates a source file exercising construction, `get<T>`,
+// `is_alternative<T>`, `visit` and copies for every alternative, then
+// compiles it with the same compiler as the rest of the build, at a fixed
+// `-std=c++14 -O2` so that results compare across build types.
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+    struct Measurement {
+        bool ok;
+        double seconds;
+        long peak_kib;
+    };
+
+    auto generate(std::string const& path, size_t alternatives) -> void {
+        std::ofstream out { path };
+        out << "#include \"variant/variant.hpp\"\n\n"
+               "template<int I>\n"
+               "struct Alt { int value; };\n\n"
+               "using V = variant::Variant<\n";
+        for (size_t i = 0; i < alternatives; ++i) {
+            out << "    Alt<" << i << ">"
+                << (i + 1 < alternatives ? ",\n" : ">;\n\n");
+        }
+
+        out << "struct Sum {\n"
+               "    template<int I>\n"
+               "    auto operator()(Alt<I> const& a) const -> int {\n"
+               "        return a.value + I;\n"
+               "    }\n"
+               "};\n\n"
+               "auto make(int i) -> V {\n"
+               "    switch (i) {\n";
+        for (size_t i = 0; i < alternatives; ++i) {
+            out << "    case " << i << ": return Alt<" << i << "> { i };\n";
+        }
+
+        out << "    default: return Alt<0> { 0 };\n"
+               "    }\n"
+               "}\n\n"
+               "auto touch(V& v) -> int {\n"
+               "    int sum = 0;\n";
+        for (size_t i = 0; i < alternatives; ++i) {
+            out << "    if (variant::is_alternative<Alt<" << i << ">>(v)) "
+                << "sum += variant::get<Alt<" << i << ">>(v).value;\n";
+        }
+
+        out << "    V copy = v;\n"
+               "    V moved = std::move(copy);\n"
+               "    return sum + variant::visit(Sum { }, moved);\n"
+               "}\n";
+    }
+
+    // Runs `args` to completion, reporting its wall time and the peak
+    // resident size of the child.
+    auto measure(std::vector<std::string> const& args) -> Measurement {
+        std::vector<char*> argv;
+        for (auto const& a : args) {
+            argv.push_back(const_cast<char*>(a.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        auto const start = std::chrono::steady_clock::now();
+        auto const pid = fork();
+        if (pid == 0) {
+            execvp(argv[0], argv.data());
+            _exit(127);
+        }
+
+        int status = 0;
+        rusage usage { };
+        if (pid < 0 || wait4(pid, &status, 0, &usage) < 0) {
+            return { false, 0, 0 };
+        }
+
+        std::chrono::duration<double> const elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        return {
+            WIFEXITED(status) && WEXITSTATUS(status) == 0,
+            elapsed.count(),
+            usage.ru_maxrss
+        };
+    }
+}
+
+auto main(int argc, char const** argv) -> int {
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; ++i) {
+        counts.push_back(std::strtoul(argv[i], nullptr, 10));
+    }
+
+    if (counts.empty()) {
+        counts = { 16, 64, 256 };
+    }
+
+    std::cout << std::left << std::setw(16) << "alternatives"
+              << std::right << std::setw(14) << "seconds"
+              << std::setw(16) << "peak KiB" << "\n";
+
+    int failures = 0;
+    for (auto n : counts) {
+        auto const source = std::string { VARIANT_BENCH_WORK_DIR } +
+            "/compile_time_" + std::to_string(n) + ".cpp";
+        generate(source, n);
+
+        auto const m = measure({
+            VARIANT_BENCH_CXX,
+            "-std=c++14",
+            "-O2",
+            "-I" VARIANT_BENCH_INCLUDE_DIR,
+            "-c", source,
+            "-o", source + ".o"
+        });
+
+        std::cout << std::left << std::setw(16) << n << std::right;
+        if (!m.ok) {
+            std::cout << std::setw(14) << "failed" << "\n";
+            ++failures;
+            continue;
+        }
+
+        std::cout << std::setw(14) << std::fixed << std::setprecision(2)
+                  << m.seconds << std::setw(16) << m.peak_kib << "\n";
+    }
+
+    return failures == 0 ? 0 : 1;
+}
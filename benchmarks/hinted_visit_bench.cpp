@@ -0,0 +1,99 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    template<size_t N>
+    struct Payload {
+        long value;
+    };
+
+    struct SumVisitor {
+        template<size_t N>
+        auto operator()(Payload<N> const& p) const -> long {
+            return p.value * static_cast<long>(N + 1);
+        }
+    };
+
+    // Alternative 0 for `hot_percent` of the values and one of the others,
+    // uniformly, for the rest.
+    auto make_tags(size_t count, size_t alternatives, unsigned hot_percent)
+        -> std::vector<size_t>
+    {
+        bench::Xorshift rng;
+        std::vector<size_t> tags;
+        tags.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto const r = rng();
+            tags.push_back(r % 100 < hot_percent
+                ? 0
+                : 1 + (r >> 8) % (alternatives - 1));
+        }
+
+        return tags;
+    }
+
+    template<size_t... Is>
+    auto make_values(std::vector<size_t> const& tags,
+                     std::index_sequence<Is...>)
+        -> std::vector<variant::Variant<Payload<Is>...>>
+    {
+        using Value = variant::Variant<Payload<Is>...>;
+        using Make = auto (*)(long) -> Value;
+        Make makers[] = {
+            [](long n) -> Value { return Payload<Is> { n }; }...
+        };
+
+        std::vector<Value> values;
+        values.reserve(tags.size());
+        long n = 0;
+        for (auto tag : tags) {
+            values.push_back(makers[tag](n++ & 0xff));
+        }
+
+        return values;
+    }
+
+    template<size_t N>
+    auto hinted_benchmark(unsigned hot_percent) -> void {
+        constexpr size_t count = 1 << 16;
+        constexpr size_t iterations = 200;
+
+        auto const values = make_values(
+            make_tags(count, N, hot_percent),
+            std::make_index_sequence<N> { });
+        auto const suffix = " (" + std::to_string(N) + " alternatives, " +
+            std::to_string(hot_percent) + "% hot)";
+
+        auto const plain_ns = bench::run("visit" + suffix, iterations, [&] {
+            long sum = 0;
+            for (auto const& v : values) {
+                sum += v.visit(SumVisitor { });
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        auto const hinted_ns = bench::run("visit_likely" + suffix, iterations,
+            [&] {
+                long sum = 0;
+                for (auto const& v : values) {
+                    sum += v.template visit_likely<Payload<0>>(SumVisitor { });
+                }
+                bench::do_not_optimize(sum);
+            });
+
+        std::cout << "    speedup: " << plain_ns / hinted_ns << "x\n";
+    }
+}
+
+auto hinted_visit_benchmarks() -> void {
+    for (auto hot : { 50u, 75u, 90u, 99u, 100u }) {
+        hinted_benchmark<8>(hot);
+        hinted_benchmark<32>(hot);
+    }
+}
@@ -0,0 +1,105 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include "variant/instrumentation.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Identical alternatives under different names, so that one variant
+    // can be instrumented and the other left alone.
+    template<int N>
+    struct Reading {
+        double value;
+    };
+
+    struct Note {
+        std::string text;
+    };
+}
+
+namespace variant {
+    template<>
+    struct variant_instrumentation<Reading<1>, Note, long> {
+        using type = CountingInstrumentation;
+    };
+}
+
+namespace {
+
+    using Plain = variant::Variant<Reading<0>, Note, long>;
+    using Counted = variant::Variant<Reading<1>, Note, long>;
+
+    struct Weigh {
+        template<int N>
+        auto operator()(Reading<N> const& r) const -> double {
+            return r.value;
+        }
+
+        auto operator()(Note const& n) const -> double {
+            return static_cast<double>(n.text.size());
+        }
+
+        auto operator()(long l) const -> double {
+            return static_cast<double>(l);
+        }
+    };
+
+    template<typename V, int N>
+    auto build(size_t count) -> std::vector<V> {
+        bench::Xorshift rng;
+        std::vector<V> values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto const r = rng();
+            switch (r % 4) {
+            case 0:
+                values.emplace_back(Note { "note" });
+                break;
+            case 1:
+                values.emplace_back(static_cast<long>(r >> 32));
+                break;
+            default:
+                values.emplace_back(
+                    Reading<N> { static_cast<double>(r % 1000) });
+                break;
+            }
+        }
+
+        return values;
+    }
+
+    template<typename V>
+    auto measure(std::string const& name, std::vector<V> const& values)
+        -> void
+    {
+        constexpr size_t iterations = 10;
+        auto const count = static_cast<double>(values.size());
+
+        auto const visit_ns = bench::run(name + " visit", iterations, [&] {
+            double sum = 0;
+            for (auto const& v : values) {
+                sum += v.visit(Weigh { });
+            }
+            bench::do_not_optimize(sum);
+        });
+        std::cout << "    " << visit_ns / count << " ns/visit\n";
+
+        auto const copy_ns = bench::run(name + " copy", iterations, [&] {
+            auto copy = values;
+            bench::do_not_optimize(copy.data());
+        });
+        std::cout << "    " << copy_ns / count << " ns/copy\n";
+    }
+}
+
+auto instrumentation_benchmarks() -> void {
+    constexpr size_t count = 1 << 20;
+
+    measure("uninstrumented", build<Plain, 0>(count));
+    measure("CountingInstrumentation", build<Counted, 1>(count));
+
+    variant::dump_instrumentation(std::cout);
+}
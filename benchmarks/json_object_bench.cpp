@@ -0,0 +1,104 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "json.hpp"
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    using FlatMembers = json::FlatMap<std::string, json::JsonValue>;
+    using HashMembers = std::unordered_map<std::string, json::JsonValue>;
+
+    // Roughly the same number of members in total for every object size,
+    // so the timings are comparable across sizes.
+    constexpr size_t total_members = 1 << 15;
+
+    auto make_keys(size_t count) -> std::vector<std::string> {
+        std::vector<std::string> keys;
+        for (size_t i = 0; i < count; ++i) {
+            keys.push_back("field_" + std::to_string(i));
+        }
+
+        return keys;
+    }
+
+    template<typename Map>
+    auto build(std::vector<std::string> const& keys, size_t objects)
+        -> std::vector<Map>
+    {
+        std::vector<Map> maps(objects);
+        for (auto& m : maps) {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                m.emplace(keys[i], json::number(static_cast<double>(i)));
+            }
+        }
+
+        return maps;
+    }
+
+    template<>
+    auto build<FlatMembers>(std::vector<std::string> const& keys,
+                            size_t objects)
+        -> std::vector<FlatMembers>
+    {
+        std::vector<FlatMembers> maps(objects);
+        for (auto& m : maps) {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                m.try_emplace(keys[i], json::number(static_cast<double>(i)));
+            }
+        }
+
+        return maps;
+    }
+
+    template<typename Map>
+    auto run_size(std::string const& name,
+                  std::vector<std::string> const& keys) -> void
+    {
+        constexpr size_t iterations = 10;
+        auto const objects = total_members / keys.size();
+        auto const suffix = " n=" + std::to_string(keys.size());
+
+        bench::run("object build (" + name + ")" + suffix, iterations, [&] {
+            auto maps = build<Map>(keys, objects);
+            bench::do_not_optimize(maps.data());
+        });
+
+        auto const maps = build<Map>(keys, objects);
+        bench::Xorshift rng;
+        std::vector<std::string const*> probes;
+        for (size_t i = 0; i < total_members; ++i) {
+            probes.push_back(&keys[rng() % keys.size()]);
+        }
+
+        bench::run("object lookup (" + name + ")" + suffix, iterations, [&] {
+            double sum = 0;
+            for (size_t i = 0; i < total_members; ++i) {
+                auto const& m = maps[i % objects];
+                auto it = m.find(*probes[i]);
+                sum += variant::get<json::JsonNumber>(it->second).value;
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("object iterate (" + name + ")" + suffix, iterations, [&] {
+            double sum = 0;
+            for (auto const& m : maps) {
+                for (auto const& member : m) {
+                    sum += variant::get<json::JsonNumber>(member.second).value;
+                }
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+}
+
+auto json_object_benchmarks() -> void {
+    for (size_t count : { 2, 4, 8, 16, 32, 64 }) {
+        auto const keys = make_keys(count);
+        run_size<HashMembers>("unordered_map", keys);
+        run_size<FlatMembers>("FlatMap", keys);
+    }
+}
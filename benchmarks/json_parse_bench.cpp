@@ -0,0 +1,109 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "json.hpp"
+#include "json_parse.hpp"
+#include "variant/recursive.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // A synthetic stand-in for a production payload: an array of records
+    // mixing short keys, strings with escapes, integers, fractions, flags
+    // and nested containers.
+    auto make_corpus(size_t bytes) -> std::string {
+        bench::Xorshift rng;
+        std::string out = "[\n";
+        for (size_t i = 0; out.size() < bytes; ++i) {
+            if (i) {
+                out += ",\n";
+            }
+
+            auto const r = rng();
+            out += "  {\"id\": " + std::to_string(i) +
+                   ", \"name\": \"user \\\"" + std::to_string(r % 10000) +
+                   "\\\" \\u00e9t\\u00e9\", \"score\": " +
+                   std::to_string(static_cast<double>(r % 100000) / 64.0) +
+                   ", \"active\": " + ((r & 1) ? "true" : "false") +
+                   ", \"manager\": null, \"tags\": [\"a\", \"bb\", \"ccc\"]" +
+                   ", \"location\": {\"lat\": " +
+                   std::to_string(static_cast<double>(r % 180) - 90.5) +
+                   ", \"lng\": -" + std::to_string(r % 180) + ".25" +
+                   ", \"path\": \"C:\\\\tmp\\\\data\"}}";
+        }
+
+        out += "\n]\n";
+        return out;
+    }
+
+    template<typename Scanner>
+    auto run_parse(std::string const& name,
+                   std::string const& corpus,
+                   size_t iterations) -> void
+    {
+        auto const ns = bench::run(name, iterations, [&] {
+            auto doc = json::parse_with<Scanner>(corpus.data(), corpus.size());
+            bench::do_not_optimize(doc);
+        });
+
+        std::cout << "    " << static_cast<double>(corpus.size()) / ns * 1e3
+                  << " MB/s\n";
+    }
+
+    template<typename Scanner>
+    auto run_index(std::string const& name,
+                   std::string const& corpus,
+                   size_t iterations) -> void
+    {
+        std::vector<uint32_t> index;
+        auto const ns = bench::run(name, iterations, [&] {
+            index.clear();
+            json::index_structurals<Scanner>(
+                corpus.data(), corpus.size(), index);
+            bench::do_not_optimize(index.data());
+        });
+
+        std::cout << "    " << static_cast<double>(corpus.size()) / ns * 1e3
+                  << " MB/s\n";
+    }
+}
+
+auto json_parse_benchmarks() -> void {
+    constexpr size_t iterations = 10;
+    auto const corpus = make_corpus(8 << 20);
+    std::cout << "parsing a " << corpus.size() / 1024
+              << " KiB synthetic JSON corpus\n";
+
+    run_index<json::ScalarScanner>("json structural index (scalar)",
+        corpus, iterations);
+#ifdef JSON_HAS_SSE2
+    run_index<json::Sse2Scanner>("json structural index (sse2)",
+        corpus, iterations);
+#endif
+#ifdef JSON_HAS_AVX2
+    if (json::has_avx2()) {
+        run_index<json::Avx2Scanner>("json structural index (avx2)",
+            corpus, iterations);
+    }
+#endif
+
+    run_parse<json::ScalarScanner>("json parse (scalar)", corpus, iterations);
+#ifdef JSON_HAS_SSE2
+    run_parse<json::Sse2Scanner>("json parse (sse2)", corpus, iterations);
+#endif
+#ifdef JSON_HAS_AVX2
+    if (json::has_avx2()) {
+        run_parse<json::Avx2Scanner>("json parse (avx2)", corpus, iterations);
+    }
+#endif
+
+    auto const arena_ns = bench::run("json parse (arena)", iterations, [&] {
+        variant::MonotonicArena arena;
+        variant::ArenaScope scope { arena };
+        auto doc = json::parse(corpus);
+        bench::do_not_optimize(doc);
+    });
+    std::cout << "    " << static_cast<double>(corpus.size()) / arena_ns * 1e3
+              << " MB/s\n";
+}
@@ -0,0 +1,89 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "json.hpp"
+#include "json_write.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+    // Records mixing fractional and whole numbers, flags, nulls and
+    // strings, some of which need escaping.
+    auto build_document(size_t count) -> json::JsonValue {
+        bench::Xorshift rng;
+        json::JsonArrayProxy root { json::JsonArray { } };
+        root->values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto const r = rng();
+            root->values.push_back(json::object({
+                { "id", json::number(static_cast<double>(i)) },
+                { "score", json::number(static_cast<double>(r % 100000) / 7.0) },
+                { "name", json::string("user " + std::to_string(r % 1000) +
+                    " of a reasonably long display name") },
+                { "path", json::string("C:\\tmp\\\"quoted\"\n") },
+                { "active", json::boolean(r & 1) },
+                { "manager", json::null() },
+                { "location", json::array({
+                    json::number(static_cast<double>(r % 180) - 90.25),
+                    json::number(-static_cast<double>(r % 360) / 3.0)
+                }) }
+            }));
+        }
+
+        return root;
+    }
+
+    auto report(std::string const& name, size_t bytes, double ns) -> void {
+        std::cout << "    " << name << ": "
+                  << static_cast<double>(bytes) / ns * 1e3 << " MB/s\n";
+    }
+}
+
+auto json_write_benchmarks() -> void {
+    constexpr size_t iterations = 10;
+    auto const doc = build_document(1 << 15);
+
+    std::ostringstream probe;
+    probe << doc;
+    auto const stream_bytes = probe.str().size();
+    auto const buffer_bytes = json::serialize(doc).size();
+
+    auto const stream_ns = bench::run("json write (ostringstream)", iterations,
+        [&] {
+            std::ostringstream out;
+            out << doc;
+            bench::do_not_optimize(out);
+        });
+    report("ostringstream", stream_bytes, stream_ns);
+
+    json::OutputBuffer buffer;
+    auto const buffer_ns = bench::run("json write (OutputBuffer)", iterations,
+        [&] {
+            buffer.clear();
+            json::serialize(doc, buffer);
+            bench::do_not_optimize(buffer.data());
+        });
+    report("OutputBuffer", buffer_bytes, buffer_ns);
+
+    std::ofstream null_stream { "/dev/null" };
+    auto* null_file = std::fopen("/dev/null", "wb");
+    if (!null_stream || !null_file) {
+        if (null_file) {
+            std::fclose(null_file);
+        }
+        return;
+    }
+
+    auto const ofstream_ns = bench::run("json write (ofstream /dev/null)",
+        iterations, [&] { null_stream << doc; });
+    report("ofstream", stream_bytes, ofstream_ns);
+
+    auto const file_ns = bench::run("json write (FILE* /dev/null)",
+        iterations, [&] { json::write(null_file, doc); });
+    report("FILE*", buffer_bytes, file_ns);
+
+    std::fclose(null_file);
+}
@@ -0,0 +1,172 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using BenchFunc = void (*)();
+
+namespace {
+
+    struct Group {
+        char const* name;
+        BenchFunc run;
+    };
+
+    enum class Format { Text, Csv, Json };
+
+    auto usage(char const* program) -> int {
+        std::cerr << "usage: " << program
+                  << " [--list] [--format=text|csv|json] [group...]\n"
+                     "Runs the named groups, or every group. A name ending "
+                     "in '*' selects every group\nstarting with the rest, "
+                     "e.g. json*.\n";
+        return 1;
+    }
+
+    // Whether `filter` names `group` exactly, or is a prefix of it
+    // followed by '*'.
+    auto matches(std::string const& filter, char const* group) -> bool {
+        if (!filter.empty() && filter.back() == '*') {
+            auto const prefix = filter.size() - 1;
+            return std::strncmp(group, filter.c_str(), prefix) == 0;
+        }
+
+        return filter == group;
+    }
+
+    auto write_json_string(std::ostream& os, std::string const& s) -> void {
+        os << '"';
+        for (auto c : s) {
+            if (c == '"' || c == '\\') {
+                os << '\\';
+            }
+            os << c;
+        }
+        os << '"';
+    }
+
+    auto write_csv_string(std::ostream& os, std::string const& s) -> void {
+        os << '"';
+        for (auto c : s) {
+            if (c == '"') {
+                os << '"';
+            }
+            os << c;
+        }
+        os << '"';
+    }
+
+    auto write_results(std::ostream& os, Format format) -> void {
+        auto const& results = bench::results();
+        os.precision(2);
+        os << std::fixed;
+        if (format == Format::Csv) {
+            os << "name,iterations,ns_per_iter\n";
+            for (auto const& r : results) {
+                write_csv_string(os, r.name);
+                os << ',' << r.iterations << ',' << r.ns_per_iter << '\n';
+            }
+            return;
+        }
+
+        os << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            os << "  { \"name\": ";
+            write_json_string(os, results[i].name);
+            os << ", \"iterations\": " << results[i].iterations
+               << ", \"ns_per_iter\": " << results[i].ns_per_iter << " }"
+               << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        os << "]\n";
+    }
+}
+
+auto main(int argc, char const** argv) -> int {
+
+    Group groups[] = {
+        { "visit", visit_benchmarks },
+        { "multi_visit", multi_visit_benchmarks },
+        { "operations", operations_benchmarks },
+        { "assign", assign_benchmarks },
+        { "variant_vector", variant_vector_benchmarks },
+        { "visit_each", visit_each_benchmarks },
+        { "parallel", parallel_benchmarks },
+        { "comparison", comparison_benchmarks },
+        { "recursive", recursive_benchmarks },
+        { "json_parse", json_parse_benchmarks },
+        { "json_write", json_write_benchmarks },
+        { "json_object", json_object_benchmarks },
+        { "boxed", boxed_benchmarks },
+        { "serialize", serialize_benchmarks },
+        { "view", view_benchmarks },
+        { "atomic", atomic_benchmarks },
+        { "instrumentation", instrumentation_benchmarks },
+        { "hinted_visit", hinted_visit_benchmarks }
+    };
+
+    auto format = Format::Text;
+    std::vector<std::string> filters;
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--list") {
+            for (auto const& g : groups) {
+                std::cout << g.name << "\n";
+            }
+            return 0;
+        }
+        else if (arg == "--format=text") {
+            format = Format::Text;
+        }
+        else if (arg == "--format=csv") {
+            format = Format::Csv;
+        }
+        else if (arg == "--format=json") {
+            format = Format::Json;
+        }
+        else if (arg.compare(0, 2, "--") == 0) {
+            return usage(argv[0]);
+        }
+        else {
+            filters.push_back(arg);
+        }
+    }
+
+    for (auto const& f : filters) {
+        bool known = false;
+        for (auto const& g : groups) {
+            known = known || matches(f, g.name);
+        }
+
+        if (!known) {
+            std::cerr << "no benchmark group matches " << f << "\n";
+            return usage(argv[0]);
+        }
+    }
+
+    // The human-readable report goes to stderr when stdout carries the
+    // machine-readable one.
+    auto* stdout_buffer = std::cout.rdbuf();
+    if (format != Format::Text) {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+
+    for (auto const& g : groups) {
+        bool selected = filters.empty();
+        for (auto const& f : filters) {
+            selected = selected || matches(f, g.name);
+        }
+
+        if (selected) {
+            g.run();
+        }
+    }
+
+    std::cout.rdbuf(stdout_buffer);
+    if (format != Format::Text) {
+        write_results(std::cout, format);
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include <utility>
+#include <vector>
+
+namespace {
+
+    template<size_t N>
+    struct Operand {
+        long value;
+    };
+
+    struct Combine {
+        template<size_t I, size_t J>
+        auto operator()(Operand<I> const& a, Operand<J> const& b) const 
+            -> long 
+        {
+            return a.value * static_cast<long>(I + 1) - 
+                b.value * static_cast<long>(J + 1);
+        }
+    };
+
+    template<size_t... Is>
+    auto make_operands(size_t count, std::index_sequence<Is...>)
+        -> std::vector<variant::Variant<Operand<Is>...>>
+    {
+        using Value = variant::Variant<Operand<Is>...>;
+        using Make = auto (*)(long) -> Value;
+        Make makers[] = { 
+            [](long n) -> Value { return Operand<Is> { n }; }... 
+        };
+
+        bench::Xorshift rng;
+        std::vector<Value> values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto r = rng();
+            values.push_back(
+                makers[r % sizeof...(Is)](static_cast<long>(r >> 56)));
+        }
+
+        return values;
+    }
+
+    template<size_t N>
+    auto multi_visit_benchmark() -> void {
+        constexpr size_t count = 1 << 16;
+        constexpr size_t iterations = 200;
+
+        auto values = 
+            make_operands(count + 1, std::make_index_sequence<N> { });
+        auto const suffix = 
+            " (" + std::to_string(N) + "x" + std::to_string(N) + ")";
+
+        bench::run("variant::visit(f, a, b)" + suffix, iterations, [&] {
+            long sum = 0;
+            for (size_t i = 0; i < count; ++i) {
+                sum += variant::visit(Combine { }, values[i], values[i + 1]);
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("nested variant::visit" + suffix, iterations, [&] {
+            long sum = 0;
+            for (size_t i = 0; i < count; ++i) {
+                auto const& b = values[i + 1];
+                sum += variant::visit(
+                    [&b](auto const& x) {
+                        return variant::visit(
+                            [&x](auto const& y) { 
+                                return Combine { }(x, y); 
+                            },
+                            b);
+                    },
+                    values[i]);
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+}
+
+auto multi_visit_benchmarks() -> void {
+    multi_visit_benchmark<2>();
+    multi_visit_benchmark<4>();
+    multi_visit_benchmark<8>();
+    multi_visit_benchmark<16>();
+}
@@ -0,0 +1,196 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <variant>
+#define VARIANT_BENCH_HAS_STD_VARIANT 1
+#endif
+
+namespace {
+
+    // Alternative `I` of a variant whose alternatives are all `Bytes`
+    // bytes and trivially copyable.
+    template<size_t I, size_t Bytes>
+    struct Blob {
+        long value;
+        std::array<char, Bytes - sizeof(long)> pad;
+    };
+
+    // Alternative `I` of a variant whose alternatives own heap memory, so
+    // that copies allocate and moves don't.
+    template<size_t I>
+    struct Text {
+        std::string value;
+    };
+
+    template<size_t Bytes>
+    struct Blobs {
+        template<size_t I>
+        using type = Blob<I, Bytes>;
+
+        template<size_t I>
+        static auto make(long n) -> type<I> {
+            return { n, { } };
+        }
+
+        static auto name() -> std::string {
+            return std::to_string(Bytes) + "B";
+        }
+    };
+
+    struct Texts {
+        template<size_t I>
+        using type = Text<I>;
+
+        template<size_t I>
+        static auto make(long n) -> type<I> {
+            return { std::string(32, static_cast<char>('a' + n % 26)) };
+        }
+
+        static auto name() -> std::string {
+            return "string";
+        }
+    };
+
+    struct SumVisitor {
+        template<size_t I, size_t Bytes>
+        auto operator()(Blob<I, Bytes> const& b) const -> long {
+            return b.value + static_cast<long>(I);
+        }
+
+        template<size_t I>
+        auto operator()(Text<I> const& t) const -> long {
+            return static_cast<long>(t.value.size() + I);
+        }
+    };
+
+    auto make_tags(size_t count, size_t alternatives, unsigned long long seed)
+        -> std::vector<size_t>
+    {
+        bench::Xorshift rng { seed };
+        std::vector<size_t> tags;
+        tags.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            tags.push_back(rng() % alternatives);
+        }
+
+        return tags;
+    }
+
+    template<typename Family, template<typename...> class V, size_t... Is>
+    auto make_values(std::vector<size_t> const& tags,
+                     std::index_sequence<Is...>)
+        -> std::vector<V<typename Family::template type<Is>...>>
+    {
+        using Value = V<typename Family::template type<Is>...>;
+        using Make = auto (*)(long) -> Value;
+        Make makers[] = {
+            [](long n) -> Value {
+                return Family::template make<Is>(n);
+            }...
+        };
+
+        std::vector<Value> values;
+        values.reserve(tags.size());
+        long n = 0;
+        for (auto tag : tags) {
+            values.push_back(makers[tag](n++ & 0xff));
+        }
+
+        return values;
+    }
+
+    template<typename Family, template<typename...> class V, size_t N>
+    auto operations_benchmark(std::string const& impl) -> void {
+        constexpr size_t count = 1 << 12;
+        constexpr size_t iterations = 50;
+        using Indices = std::make_index_sequence<N>;
+
+        auto const tags = make_tags(count, N, 0x9e3779b97f4a7c15ull);
+        auto const values = make_values<Family, V>(tags, Indices { });
+        auto const others = make_values<Family, V>(
+            make_tags(count, N, 0xc2b2ae3d27d4eb4full), Indices { });
+        using Value = typename decltype(values)::value_type;
+
+        auto const suffix = " (" + impl + ", " + std::to_string(N) +
+            " x " + Family::name() + ")";
+
+        bench::run("construct" + suffix, iterations, [&] {
+            auto built = make_values<Family, V>(tags, Indices { });
+            bench::do_not_optimize(built.data());
+        });
+
+        bench::run("copy construct" + suffix, iterations, [&] {
+            std::vector<Value> copy = values;
+            bench::do_not_optimize(copy.data());
+        });
+
+        // Moves everything across and back again on alternate iterations,
+        // so every move starts from a full value.
+        auto source = values;
+        std::vector<Value> target;
+        target.reserve(count);
+        bench::run("move construct" + suffix, iterations, [&] {
+            target.clear();
+            for (auto& v : source) {
+                target.emplace_back(std::move(v));
+            }
+            source.swap(target);
+            bench::do_not_optimize(source.data());
+        });
+
+        // Alternates between two sets of values, so most assignments
+        // change the alternative.
+        auto work = values;
+        bool flip = false;
+        bench::run("copy assign" + suffix, iterations, [&] {
+            auto const& from = flip ? others : values;
+            for (size_t i = 0; i < count; ++i) {
+                work[i] = from[i];
+            }
+            flip = !flip;
+            bench::do_not_optimize(work.data());
+        });
+
+        bench::run("visit" + suffix, iterations, [&] {
+            long sum = 0;
+            for (auto const& v : values) {
+                sum += visit(SumVisitor { }, v);
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    template<typename Family, size_t N>
+    auto compare_implementations() -> void {
+        operations_benchmark<Family, variant::Variant, N>("Variant");
+#ifdef VARIANT_BENCH_HAS_STD_VARIANT
+        operations_benchmark<Family, std::variant, N>("std::variant");
+#endif
+    }
+
+    template<typename Family>
+    auto across_alternative_counts() -> void {
+        compare_implementations<Family, 2>();
+        compare_implementations<Family, 4>();
+        compare_implementations<Family, 8>();
+        compare_implementations<Family, 16>();
+        compare_implementations<Family, 32>();
+        compare_implementations<Family, 64>();
+    }
+}
+
+// Construction, copies, moves, assignment and visitation across 2 to 64
+// alternatives and several payload sizes, for `Variant` and, where the
+// standard library has it, `std::variant`.
+auto operations_benchmarks() -> void {
+    across_alternative_counts<Blobs<8>>();
+    across_alternative_counts<Blobs<64>>();
+    across_alternative_counts<Blobs<256>>();
+    across_alternative_counts<Texts>();
+}
@@ -0,0 +1,124 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "json.hpp"
+#include "variant/parallel.hpp"
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // Roughly the work a validator or indexer does per value: hash strings, 
+    // classify numbers and recurse into nested containers.
+    struct Weigh {
+        auto operator()(json::JsonString const& s) const -> size_t {
+            return std::hash<std::string> { }(s.value);
+        }
+
+        auto operator()(json::JsonNumber const& n) const -> size_t {
+            return static_cast<size_t>(n.value * 31.0);
+        }
+
+        auto operator()(json::JsonBool const& b) const -> size_t {
+            return b.value ? 3 : 2;
+        }
+
+        auto operator()(json::JsonArrayProxy const& a) const -> size_t {
+            size_t total = 0;
+            for (auto const& v : a->values) {
+                total += v.visit(*this);
+            }
+            return total;
+        }
+
+        auto operator()(json::JsonObjectProxy const& o) const -> size_t {
+            size_t total = 0;
+            for (auto const& m : o->members) {
+                total += std::hash<std::string> { }(m.first) + 
+                    m.second.visit(*this);
+            }
+            return total;
+        }
+
+        auto operator()(json::JsonNull const&) const -> size_t {
+            return 1;
+        }
+    };
+
+    auto make_document(size_t count) -> std::vector<json::JsonValue> {
+        bench::Xorshift rng;
+        std::vector<json::JsonValue> values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto r = rng();
+            switch (r % 5) {
+            case 0: 
+                values.push_back(json::string(std::to_string(r)));
+                break;
+            case 1: 
+                values.push_back(json::number(static_cast<double>(r >> 40)));
+                break;
+            case 2: 
+                values.push_back(json::array({ 
+                    json::number(1.0), 
+                    json::string("element"), 
+                    json::null() 
+                }));
+                break;
+            case 3: 
+                values.push_back(json::object({ 
+                    { "id", json::number(static_cast<double>(i)) },
+                    { "name", json::string(std::to_string(r >> 20)) }
+                }));
+                break;
+            default: 
+                values.push_back(json::null());
+                break;
+            }
+        }
+
+        return values;
+    }
+}
+
+auto parallel_benchmarks() -> void {
+    constexpr size_t count = 1 << 20;
+    constexpr size_t iterations = 10;
+
+    auto const document = make_document(count);
+    auto const cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::cout << "parallel_visit_reduce over " << count 
+              << " JsonValues, " << cores << " hardware threads\n";
+
+    auto const serial = bench::run("serial visit", iterations, [&] {
+        size_t total = 0;
+        for (auto const& v : document) {
+            total += v.visit(Weigh { });
+        }
+        bench::do_not_optimize(total);
+    });
+
+    for (unsigned threads = 1; threads <= cores; ++threads) {
+        variant::ThreadPool pool { threads };
+        auto const parallel = bench::run(
+            "parallel_visit_reduce (" + std::to_string(threads) + " threads)", 
+            iterations, 
+            [&] {
+                auto total = variant::parallel_visit_reduce(
+                    document, 
+                    Weigh { }, 
+                    size_t { 0 }, 
+                    std::plus<size_t> { }, 
+                    pool);
+                bench::do_not_optimize(total);
+            });
+
+        std::cout << "    speedup over serial: " << std::setprecision(2) 
+                  << serial / parallel << "x\n";
+    }
+}
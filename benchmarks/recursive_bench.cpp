@@ -0,0 +1,63 @@
+#include "benchmarks.hpp"
+#include "allocations.hpp"
+#include "bench.hpp"
+#include "json.hpp"
+#include "variant/recursive.hpp"
+#include <iostream>
+#include <string>
+
+namespace {
+
+    // An array of `count` small records, each an object holding a nested
+    // array, so that most allocations are container nodes.
+    auto build_document(size_t count) -> json::JsonValue {
+        json::JsonArrayProxy root { json::JsonArray { } };
+        root->values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto n = static_cast<double>(i);
+            root->values.push_back(json::object({
+                { "id", json::number(n) },
+                { "tags", json::array({ 
+                    json::number(n), 
+                    json::null(), 
+                    json::array({ json::number(n) }) 
+                }) }
+            }));
+        }
+
+        return root;
+    }
+
+    template<typename F>
+    auto count_allocations(F&& f) -> size_t {
+        auto const before = bench::allocations();
+        f();
+        return bench::allocations() - before;
+    }
+}
+
+auto recursive_benchmarks() -> void {
+    constexpr size_t count = 1 << 14;
+    constexpr size_t iterations = 20;
+
+    auto const heap_build = [&] {
+        auto doc = build_document(count);
+        bench::do_not_optimize(doc);
+    };
+
+    auto const arena_build = [&] {
+        variant::MonotonicArena arena;
+        {
+            variant::ArenaScope scope { arena };
+            auto doc = build_document(count);
+            bench::do_not_optimize(doc);
+        }
+    };
+
+    std::cout << "build and destroy " << count << " JSON records: " 
+              << count_allocations(heap_build) << " allocations on the heap, "
+              << count_allocations(arena_build) << " with an arena\n";
+
+    bench::run("json build/teardown (heap)", iterations, heap_build);
+    bench::run("json build/teardown (arena)", iterations, arena_build);
+}
@@ -0,0 +1,126 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include "variant/serialize.hpp"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    struct Trade {
+        std::int64_t timestamp;
+        double price;
+        std::int32_t quantity;
+        std::int32_t venue;
+    };
+
+    struct Quote {
+        std::int64_t timestamp;
+        double bid;
+        double ask;
+    };
+
+    struct Heartbeat {
+        std::int64_t timestamp;
+    };
+
+    using Record = variant::Variant<Trade, Quote, Heartbeat>;
+
+    struct Price {
+        auto operator()(Trade const& t) const -> double { return t.price; }
+        auto operator()(Quote const& q) const -> double { return q.bid; }
+        auto operator()(Heartbeat const&) const -> double { return 0; }
+    };
+
+    auto build(size_t count) -> std::vector<Record> {
+        bench::Xorshift rng;
+        std::vector<Record> records;
+        records.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto const r = rng();
+            auto const ts = static_cast<std::int64_t>(i);
+            auto const px = static_cast<double>(r % 10000) / 100.0;
+            switch (r % 8) {
+            case 0:
+                records.emplace_back(Heartbeat { ts });
+                break;
+            case 1: case 2: case 3:
+                records.emplace_back(Trade {
+                    ts, px, static_cast<std::int32_t>(r % 500), 1 });
+                break;
+            default:
+                records.emplace_back(Quote { ts, px, px + 0.01 });
+                break;
+            }
+        }
+
+        return records;
+    }
+
+    auto report(std::string const& name,
+                size_t bytes,
+                size_t count,
+                double ns) -> void
+    {
+        std::cout << "    " << name << ": "
+                  << static_cast<double>(bytes) / ns * 1e3 << " MB/s, "
+                  << ns / static_cast<double>(count) << " ns/record\n";
+    }
+}
+
+auto serialize_benchmarks() -> void {
+    constexpr size_t iterations = 5;
+    constexpr size_t count = 1 << 21;
+    auto const records = build(count);
+
+    variant::BinaryWriter w;
+    auto const write_ns = bench::run("serialize (2M records)", iterations,
+        [&] {
+            w.clear();
+            for (auto const& r : records) {
+                variant::serialize(w, r);
+            }
+            bench::do_not_optimize(w.data());
+        });
+    report("serialize", w.size(), count, write_ns);
+
+    auto const bytes = w.release();
+
+    std::vector<Record> decoded;
+    decoded.reserve(count);
+    auto const read_ns = bench::run("deserialize (2M records)", iterations,
+        [&] {
+            decoded.clear();
+            variant::BinaryReader r { bytes };
+            while (!r.empty()) {
+                decoded.push_back(variant::deserialize<Record>(r));
+            }
+            bench::do_not_optimize(decoded.data());
+        });
+    report("deserialize", bytes.size(), count, read_ns);
+
+    auto const view_ns = bench::run("visit_serialized (2M records)",
+        iterations,
+        [&] {
+            double sum = 0;
+            variant::BinaryReader r { bytes };
+            while (!r.empty()) {
+                sum += variant::visit_serialized<Record>(r, Price { });
+            }
+            bench::do_not_optimize(sum);
+        });
+    report("visit_serialized", bytes.size(), count, view_ns);
+
+    auto const visit_ns = bench::run("visit in memory (2M records)",
+        iterations,
+        [&] {
+            double sum = 0;
+            for (auto const& r : records) {
+                sum += r.visit(Price { });
+            }
+            bench::do_not_optimize(sum);
+        });
+    report("visit in memory", count * sizeof(Record), count, visit_ns);
+}
@@ -0,0 +1,157 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include "variant/variant_vector.hpp"
+#include <iostream>
+#include <vector>
+
+namespace {
+
+    struct Small {
+        int value;
+    };
+
+    struct Medium {
+        double values[4];
+    };
+
+    struct Large {
+        long values[32];
+    };
+
+    struct Sum {
+        auto operator()(Small const& s) -> void { total += s.value; }
+        auto operator()(Medium const& m) -> void { total += m.values[0]; }
+        auto operator()(Large const& l) -> void { total += l.values[0]; }
+
+        double total = 0;
+    };
+
+    template<typename T>
+    auto pool_bytes(std::vector<T> const& pool) -> size_t {
+        return pool.size() * sizeof(T);
+    }
+
+    // `small_percent` of elements are `Small`, the rest split evenly 
+    // between `Medium` and `Large`.
+    auto variant_vector_benchmark(unsigned small_percent) -> void {
+        constexpr size_t count = 1 << 18;
+        constexpr size_t iterations = 50;
+
+        using MyVariant = variant::Variant<Small, Medium, Large>;
+        std::vector<MyVariant> aos;
+        variant::VariantVector<Small, Medium, Large> soa;
+
+        bench::Xorshift rng;
+        aos.reserve(count);
+        soa.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto r = rng();
+            auto n = static_cast<int>(r >> 48);
+            if (r % 100 < small_percent) {
+                aos.push_back(Small { n });
+                soa.push_back(Small { n });
+            }
+            else if (r & 0x100) {
+                aos.push_back(Medium { { double(n) } });
+                soa.push_back(Medium { { double(n) } });
+            }
+            else {
+                aos.push_back(Large { { n } });
+                soa.push_back(Large { { n } });
+            }
+        }
+
+        auto const suffix = " (" + std::to_string(small_percent) + "% small)";
+        auto const soa_bytes = 
+            soa.size() * (sizeof(decltype(soa)::tag_type) + 
+                          sizeof(decltype(soa)::offset_type)) +
+            pool_bytes(soa.pool<Small>()) +
+            pool_bytes(soa.pool<Medium>()) +
+            pool_bytes(soa.pool<Large>());
+
+        std::cout << "std::vector<Variant> bytes" << suffix << ": " 
+                  << aos.size() * sizeof(MyVariant) << "\n"
+                  << "VariantVector bytes" << suffix << ": " 
+                  << soa_bytes << "\n";
+
+        bench::run("std::vector<Variant> visit" + suffix, iterations, [&] {
+            Sum sum;
+            for (auto const& v : aos) {
+                v.visit(sum);
+            }
+            bench::do_not_optimize(sum.total);
+        });
+
+        bench::run("VariantVector::visit_all" + suffix, iterations, [&] {
+            Sum sum;
+            soa.visit_all(sum);
+            bench::do_not_optimize(sum.total);
+        });
+    }
+
+    // Alternatives no bigger than the tag and offset, where splitting
+    // into pools saves the least.
+    auto small_variant_vector_benchmark() -> void {
+        constexpr size_t count = 1 << 18;
+        constexpr size_t iterations = 50;
+
+        using MyVariant = variant::Variant<int, double>;
+        std::vector<MyVariant> aos;
+        variant::VariantVector<int, double> soa;
+
+        bench::Xorshift rng;
+        aos.reserve(count);
+        soa.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto r = rng();
+            auto n = static_cast<int>(r >> 48);
+            if (r & 0x100) {
+                aos.push_back(n);
+                soa.push_back(n);
+            }
+            else {
+                aos.push_back(double(n));
+                soa.push_back(double(n));
+            }
+        }
+
+        auto const soa_bytes = 
+            soa.size() * (sizeof(decltype(soa)::tag_type) + 
+                          sizeof(decltype(soa)::offset_type)) +
+            pool_bytes(soa.pool<int>()) +
+            pool_bytes(soa.pool<double>());
+
+        std::cout << "std::vector<Variant<int, double>> bytes: " 
+                  << aos.size() * sizeof(MyVariant) << "\n"
+                  << "VariantVector<int, double> bytes: " 
+                  << soa_bytes << "\n";
+
+        auto sum = [](double& total) {
+            return [&total](auto val) { total += val; };
+        };
+
+        bench::run("std::vector<Variant<int, double>> visit", iterations, 
+            [&] {
+                double total = 0;
+                auto add = sum(total);
+                for (auto const& v : aos) {
+                    v.visit(add);
+                }
+                bench::do_not_optimize(total);
+            });
+
+        bench::run("VariantVector<int, double>::visit_all", iterations, [&] {
+            double total = 0;
+            soa.visit_all(sum(total));
+            bench::do_not_optimize(total);
+        });
+    }
+}
+
+auto variant_vector_benchmarks() -> void {
+    variant_vector_benchmark(50);
+    variant_vector_benchmark(90);
+    variant_vector_benchmark(99);
+    small_variant_vector_benchmark();
+}
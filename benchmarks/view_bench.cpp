@@ -0,0 +1,177 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include "variant/serialize.hpp"
+#include "variant/view.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define VARIANT_BENCH_HAS_MMAP 1
+#endif
+
+namespace {
+
+    struct Trade {
+        std::int64_t timestamp;
+        double price;
+        std::int32_t quantity;
+        std::int32_t venue;
+    };
+
+    struct Quote {
+        std::int64_t timestamp;
+        double bid;
+        double ask;
+    };
+
+    struct Heartbeat {
+        std::int64_t timestamp;
+    };
+
+    using Record = variant::Variant<Trade, Quote, Heartbeat>;
+
+    struct Price {
+        auto operator()(Trade const& t) const -> double { return t.price; }
+        auto operator()(Quote const& q) const -> double { return q.bid; }
+        auto operator()(Heartbeat const&) const -> double { return 0; }
+    };
+
+    auto write_stream(size_t count) -> std::vector<unsigned char> {
+        bench::Xorshift rng;
+        variant::BinaryWriter w;
+        for (size_t i = 0; i < count; ++i) {
+            auto const r = rng();
+            auto const ts = static_cast<std::int64_t>(i);
+            auto const px = static_cast<double>(r % 10000) / 100.0;
+            switch (r % 8) {
+            case 0:
+                variant::serialize(w, Record { Heartbeat { ts } });
+                break;
+            case 1: case 2: case 3:
+                variant::serialize(w, Record { Trade {
+                    ts, px, static_cast<std::int32_t>(r % 500), 1 } });
+                break;
+            default:
+                variant::serialize(w, Record { Quote { ts, px, px + 0.01 } });
+                break;
+            }
+        }
+
+        return w.release();
+    }
+
+    // The capture, either mapped from a file or, where mapping isn't
+    // available, held in memory.
+    struct Capture {
+        explicit Capture(std::vector<unsigned char> bytes) :
+            bytes_ { std::move(bytes) },
+            data_ { bytes_.data() },
+            size_ { bytes_.size() }
+        {
+#ifdef VARIANT_BENCH_HAS_MMAP
+            char path[] = "/tmp/variant_view_benchXXXXXX";
+            auto const fd = mkstemp(path);
+            if (fd < 0) {
+                return;
+            }
+
+            unlink(path);
+            auto const written = ::write(fd, bytes_.data(), bytes_.size());
+            auto* mapped = written == static_cast<ssize_t>(bytes_.size())
+                ? mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0)
+                : MAP_FAILED;
+            close(fd);
+            if (mapped != MAP_FAILED) {
+                mapped_ = mapped;
+                data_ = static_cast<unsigned char const*>(mapped);
+                std::vector<unsigned char> { }.swap(bytes_);
+            }
+#endif
+        }
+
+        Capture(Capture const&) = delete;
+        Capture& operator=(Capture const&) = delete;
+
+        ~Capture() {
+#ifdef VARIANT_BENCH_HAS_MMAP
+            if (mapped_) {
+                munmap(mapped_, size_);
+            }
+#endif
+        }
+
+        auto data() const -> unsigned char const* { return data_; }
+        auto size() const -> size_t { return size_; }
+        auto mapped() const -> bool { return mapped_ != nullptr; }
+
+    private:
+        std::vector<unsigned char> bytes_;
+        unsigned char const* data_;
+        size_t size_;
+        void* mapped_ = nullptr;
+    };
+
+    auto report(std::string const& name, size_t bytes, double ns) -> void {
+        std::cout << "    " << name << ": "
+                  << static_cast<double>(bytes) / ns * 1e3 << " MB/s\n";
+    }
+}
+
+auto view_benchmarks() -> void {
+    constexpr size_t iterations = 5;
+    Capture const capture { write_stream(1 << 22) };
+    std::cout << "    " << capture.size() / (1024 * 1024) << " MiB capture, "
+              << (capture.mapped() ? "mapped" : "in memory") << "\n";
+
+    // The floor: touching every word of the capture and nothing else
+    auto const scan_ns = bench::run("view scan bytes", iterations, [&] {
+        std::uint64_t sum = 0;
+        for (size_t i = 0; i + 8 <= capture.size(); i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, capture.data() + i, sizeof(word));
+            sum += word;
+        }
+        bench::do_not_optimize(sum);
+    });
+    report("scan bytes", capture.size(), scan_ns);
+
+    auto const view_ns = bench::run("view records", iterations, [&] {
+        double sum = 0;
+        for (auto const& v :
+                variant::records<Record>(capture.data(), capture.size())) {
+            sum += v.visit(Price { });
+        }
+        bench::do_not_optimize(sum);
+    });
+    report("VariantView", capture.size(), view_ns);
+
+    auto const serialized_ns = bench::run("view visit_serialized", iterations,
+        [&] {
+            double sum = 0;
+            variant::BinaryReader r { capture.data(), capture.size() };
+            while (!r.empty()) {
+                sum += variant::visit_serialized<Record>(r, Price { });
+            }
+            bench::do_not_optimize(sum);
+        });
+    report("visit_serialized", capture.size(), serialized_ns);
+
+    auto const copy_ns = bench::run("view deserialize then visit", iterations,
+        [&] {
+            double sum = 0;
+            variant::BinaryReader r { capture.data(), capture.size() };
+            while (!r.empty()) {
+                sum += variant::deserialize<Record>(r).visit(Price { });
+            }
+            bench::do_not_optimize(sum);
+        });
+    report("deserialize", capture.size(), copy_ns);
+}
@@ -0,0 +1,121 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <variant>
+#define VARIANT_BENCH_HAS_STD_VARIANT 1
+#endif
+
+namespace {
+
+    template<size_t N>
+    struct Payload {
+        long value;
+    };
+
+    struct SumVisitor {
+        template<size_t N>
+        auto operator()(Payload<N> const& p) const -> long {
+            return p.value + static_cast<long>(N);
+        }
+    };
+
+    // The dispatch `VariantStorage::visit` used to do: a function pointer
+    // array rebuilt on the stack for every call.
+    // Like it, each path reaches the alternative without checking the
+    // index again.
+    template<size_t I, typename F, typename V>
+    auto stack_path(F& f, V const& v) -> long {
+        return f(variant::VisitDispatcher::get<I>(v));
+    }
+
+    template<typename F, typename V, size_t... Is>
+    auto stack_table_visit(F& f, V const& v, std::index_sequence<Is...>) 
+        -> long
+    {
+        using Fn = long (*)(F&, V const&);
+        Fn paths[sizeof...(Is)] = { stack_path<Is, F, V>... };
+        return (paths[v.index()])(f, v);
+    }
+
+    auto make_tags(size_t count, size_t alternatives) -> std::vector<size_t> {
+        bench::Xorshift rng;
+        std::vector<size_t> tags;
+        tags.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            tags.push_back(rng() % alternatives);
+        }
+
+        return tags;
+    }
+
+    template<template<typename...> class V, size_t... Is>
+    auto make_values(std::vector<size_t> const& tags, 
+                     std::index_sequence<Is...>)
+        -> std::vector<V<Payload<Is>...>>
+    {
+        using Value = V<Payload<Is>...>;
+        using Make = auto (*)(long) -> Value;
+        Make makers[] = { 
+            [](long n) -> Value { return Payload<Is> { n }; }... 
+        };
+
+        std::vector<Value> values;
+        values.reserve(tags.size());
+        long n = 0;
+        for (auto tag : tags) {
+            values.push_back(makers[tag](n++ & 0xff));
+        }
+
+        return values;
+    }
+
+    template<size_t N>
+    auto visit_benchmark() -> void {
+        constexpr size_t count = 1 << 16;
+        constexpr size_t iterations = 200;
+        using Indices = std::make_index_sequence<N>;
+
+        auto tags = make_tags(count, N);
+        auto values = make_values<variant::Variant>(tags, Indices { });
+        auto const suffix = " (" + std::to_string(N) + " alternatives)";
+
+        bench::run("Variant::visit" + suffix, iterations, [&] {
+            long sum = 0;
+            for (auto const& v : values) {
+                sum += v.visit(SumVisitor { });
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("stack table visit" + suffix, iterations, [&] {
+            long sum = 0;
+            SumVisitor f;
+            for (auto const& v : values) {
+                sum += stack_table_visit(f, v, Indices { });
+            }
+            bench::do_not_optimize(sum);
+        });
+
+#ifdef VARIANT_BENCH_HAS_STD_VARIANT
+        auto std_values = make_values<std::variant>(tags, Indices { });
+        bench::run("std::visit" + suffix, iterations, [&] {
+            long sum = 0;
+            for (auto const& v : std_values) {
+                sum += std::visit(SumVisitor { }, v);
+            }
+            bench::do_not_optimize(sum);
+        });
+#endif
+    }
+}
+
+auto visit_benchmarks() -> void {
+    visit_benchmark<2>();
+    visit_benchmark<4>();
+    visit_benchmark<8>();
+    visit_benchmark<16>();
+}
@@ -0,0 +1,92 @@
+#include "benchmarks.hpp"
+#include "bench.hpp"
+#include "variant/variant.hpp"
+#include "variant/visit_each.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+    template<size_t N>
+    struct Shape {
+        float size;
+    };
+
+    // Each alternative does slightly different work so that the compiler
+    // can't merge the dispatch targets.
+    struct Area {
+        template<size_t N>
+        auto operator()(Shape<N> const& s) -> void {
+            total += s.size * s.size * static_cast<float>(N + 1);
+        }
+
+        float total = 0;
+    };
+
+    using Shapes = variant::Variant<
+        Shape<0>, Shape<1>, Shape<2>, Shape<3>, 
+        Shape<4>, Shape<5>, Shape<6>, Shape<7>>;
+
+    template<size_t... Is>
+    auto make_shapes(size_t count, std::index_sequence<Is...>) 
+        -> std::vector<Shapes> 
+    {
+        using Make = auto (*)(float) -> Shapes;
+        Make makers[] = { 
+            [](float f) -> Shapes { return Shape<Is> { f }; }... 
+        };
+
+        bench::Xorshift rng;
+        std::vector<Shapes> shapes;
+        shapes.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto r = rng();
+            shapes.push_back(
+                makers[r % sizeof...(Is)](static_cast<float>(r >> 40)));
+        }
+
+        return shapes;
+    }
+
+    auto run_visit_each(std::string const& distribution, 
+                        std::vector<Shapes> const& shapes) 
+        -> void 
+    {
+        constexpr size_t iterations = 100;
+        auto const suffix = " (" + distribution + ")";
+
+        bench::run("per-element visit" + suffix, iterations, [&] {
+            Area area;
+            for (auto const& s : shapes) {
+                s.visit(area);
+            }
+            bench::do_not_optimize(area.total);
+        });
+
+        bench::run("visit_each" + suffix, iterations, [&] {
+            Area area;
+            variant::visit_each(shapes.begin(), shapes.end(), area);
+            bench::do_not_optimize(area.total);
+        });
+
+        bench::run("visit_each preserve_order" + suffix, iterations, [&] {
+            Area area;
+            variant::visit_each(
+                shapes.begin(), 
+                shapes.end(), 
+                area, 
+                variant::preserve_order);
+            bench::do_not_optimize(area.total);
+        });
+    }
+}
+
+auto visit_each_benchmarks() -> void {
+    constexpr size_t count = 1 << 18;
+
+    auto shapes = make_shapes(count, std::make_index_sequence<8> { });
+    run_visit_each("random tags", shapes);
+
+    variant::group_by_alternative(shapes.begin(), shapes.end());
+    run_visit_each("sorted tags", shapes);
+}
@@ -25,4 +25,7 @@ ExternalProject_Add(
     CMAKE_ARGS
         -DSKIP_SUPERBUILD=ON
         -DCMAKE_PREFIX_PATH=${CMAKE_PREFIX_PATH}
+        -DCMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE}
+        -DENABLE_VARIANT_TESTS=${ENABLE_VARIANT_TESTS}
+        -DENABLE_VARIANT_BENCHMARKS=${ENABLE_VARIANT_BENCHMARKS}
 )
@@ -1,4 +1,5 @@
 #include "json.hpp"
+#include "json_parse.hpp"
 #include <iostream>
 
 auto main(int, char const**) -> int {
@@ -20,4 +21,7 @@ auto main(int, char const**) -> int {
     });
 
     std::cout << obj << "\n";
+
+    auto parsed = json::parse(R"({ "Qux": [true, false, null, "\u00e9"] })");
+    std::cout << parsed << "\n";
 }
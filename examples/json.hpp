@@ -2,9 +2,10 @@
 #define VARIANT_EXAMPLES_JSON_HPP_INCLUDED
 
 #include "variant/variant.hpp"
+#include "variant/recursive.hpp"
+#include "json_flat_map.hpp"
 #include <memory>
 #include <vector>
-#include <unordered_map>
 #include <iostream>
 #include <string>
 
@@ -12,58 +13,20 @@ namespace json {
 
     struct JsonString { std::string value; };
     struct JsonNumber { double value; };
+    struct JsonBool { bool value; };
     struct JsonArray; 
     struct JsonObject;
     struct JsonNull { };
 
+    // Containers are held out of line and, along with their elements, 
+    // allocated from the current `variant::ArenaScope`'s arena if there is
+    // one, so that building a document needn't mean one heap allocation 
+    // per node.
     template<typename T>
-    struct JsonProxy {
+    using JsonAllocator = variant::ArenaAllocator<T>;
 
-        JsonProxy(T val) :
-            inner { std::make_unique<T>(val) }
-        { }
-
-        JsonProxy(JsonProxy const& other) :
-            inner { std::make_unique<T>(*other.inner) }
-        { }
-
-        JsonProxy(JsonProxy&&) = default;
-
-        JsonProxy& operator=(JsonProxy const& other) {
-            using std::swap;
-            JsonProxy tmp { other };
-            swap(tmp.inner, inner);
-            return *this;
-        }
-
-        JsonProxy& operator=(JsonProxy&&) = default;
-
-        operator T&() {
-            return *inner;
-        }
-
-        operator T const&() const {
-            return *inner;
-        }
-
-        T* operator->() {
-            return inner.get();
-        }
-
-        T const* operator->() const {
-            return inner.get();
-        }
-
-        T& operator*() {
-            return *inner;
-        }
-
-        T const& operator*() const {
-            return *inner;
-        }
-
-        std::unique_ptr<T> inner;
-    };
+    template<typename T>
+    using JsonProxy = variant::recursive<T, JsonAllocator<T>>;
 
     using JsonArrayProxy = JsonProxy<JsonArray>;
     using JsonObjectProxy = JsonProxy<JsonObject>;
@@ -73,6 +36,10 @@ namespace json {
     auto operator<<(std::ostream&, JsonArray const&) -> std::ostream&;
     auto operator<<(std::ostream&, JsonObject const&) -> std::ostream&;
 
+    inline auto operator<<(std::ostream& os, JsonBool const& b) -> std::ostream& {
+        return os << (b.value ? "true" : "false");
+    }
+
     inline auto operator<<(std::ostream& os, JsonNull const&) -> std::ostream& {
         return os << "null";
     }
@@ -87,18 +54,25 @@ namespace json {
     using JsonValue = 
         variant::Variant<JsonString,
                          JsonNumber,
+                         JsonBool,
                          JsonArrayProxy,
                          JsonObjectProxy,
                          JsonNull>;
 
-    using PropValuePair = std::pair<std::string const, JsonValue>;
+    using PropValuePair = std::pair<std::string, JsonValue>;
 
     struct JsonArray {
-        std::vector<JsonValue> values;
+        std::vector<JsonValue, JsonAllocator<JsonValue>> values;
     };
 
+    // Members are kept in document order. Most objects are small enough
+    // that their members sit inline, in the same allocation as the object.
+    using JsonMembers = FlatMap<std::string, 
+                                JsonValue, 
+                                JsonAllocator<PropValuePair>>;
+
     struct JsonObject {
-        std::unordered_map<std::string, JsonValue> members;
+        JsonMembers members;
     };
 
     struct JsonOutputVisitor {
@@ -114,6 +88,10 @@ namespace json {
             return os_ << n.value;
         }
 
+        auto operator()(JsonBool const& b) const -> std::ostream& {
+            return os_ << b;
+        }
+
         template<typename T>
         auto operator()(JsonProxy<T> const& p) const -> std::ostream& {
             return os_ << *p;
@@ -175,6 +153,10 @@ namespace json {
         return JsonNumber { n };
     }
 
+    inline auto boolean(bool b) -> JsonValue {
+        return JsonBool { b };
+    }
+
     inline auto null() -> JsonValue {
         return JsonNull { };
     }
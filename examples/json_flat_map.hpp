@@ -0,0 +1,442 @@
+#ifndef VARIANT_EXAMPLES_JSON_FLAT_MAP_HPP_INCLUDED
+#define VARIANT_EXAMPLES_JSON_FLAT_MAP_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace json {
+
+    enum class MemberOrder {
+        // Members iterate in the order they were inserted. Erasing one
+        // shifts those after it down.
+        Insertion,
+        // Erasing a member moves the last one into its place, so the
+        // order isn't kept.
+        Any
+    };
+
+    // A map that keeps its members in one contiguous array, the first
+    // `InlineCapacity` of them inside the map itself. Lookups scan the
+    // array until there are more than `IndexThreshold` members, after which
+    // a hashed index of positions, probed linearly, is kept alongside.
+    //
+    // Keys are reachable through iterators, as in a vector of pairs, but
+    // mustn't be changed through them.
+    template<typename Key,
+             typename T,
+             typename Alloc = std::allocator<std::pair<Key, T>>,
+             MemberOrder Order = MemberOrder::Insertion,
+             size_t InlineCapacity = 4,
+             size_t IndexThreshold = 16>
+    struct FlatMap {
+        static_assert(InlineCapacity > 0, "InlineCapacity must be at least 1");
+
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<Key, T>;
+        using allocator_type = typename std::allocator_traits<Alloc>
+            ::template rebind_alloc<value_type>;
+        using size_type = size_t;
+        using iterator = value_type*;
+        using const_iterator = value_type const*;
+
+        FlatMap() :
+            FlatMap { allocator_type { } }
+        { }
+
+        explicit FlatMap(allocator_type const& alloc) :
+            alloc_ { alloc }
+        { }
+
+        FlatMap(std::initializer_list<value_type> init,
+                allocator_type const& alloc = allocator_type { }) :
+            FlatMap { alloc }
+        {
+            reserve(init.size());
+            for (auto const& member : init) {
+                try_emplace(member.first, member.second);
+            }
+        }
+
+        FlatMap(FlatMap const& other) :
+            FlatMap {
+                Traits::select_on_container_copy_construction(other.alloc_)
+            }
+        {
+            reserve(other.size_);
+            for (auto const& member : other) {
+                Traits::construct(alloc_, data_ + size_, member);
+                ++size_;
+            }
+
+            if (other.index_) {
+                build_index();
+            }
+        }
+
+        FlatMap(FlatMap&& other) noexcept :
+            alloc_ { std::move(other.alloc_) }
+        {
+            take(other);
+        }
+
+        FlatMap& operator=(FlatMap const& other) {
+            if (this != &other) {
+                FlatMap tmp { other };
+                *this = std::move(tmp);
+            }
+
+            return *this;
+        }
+
+        FlatMap& operator=(FlatMap&& other) {
+            if (this != &other) {
+                clear();
+                release_storage();
+                if (Traits::propagate_on_container_move_assignment::value) {
+                    alloc_ = std::move(other.alloc_);
+                }
+
+                take(other);
+            }
+
+            return *this;
+        }
+
+        ~FlatMap() {
+            clear();
+            release_storage();
+        }
+
+        auto begin() noexcept -> iterator { return data_; }
+        auto end() noexcept -> iterator { return data_ + size_; }
+        auto begin() const noexcept -> const_iterator { return data_; }
+        auto end() const noexcept -> const_iterator { return data_ + size_; }
+
+        auto size() const noexcept -> size_type {
+            return size_;
+        }
+
+        auto empty() const noexcept -> bool {
+            return size_ == 0;
+        }
+
+        auto capacity() const noexcept -> size_type {
+            return capacity_;
+        }
+
+        auto is_indexed() const noexcept -> bool {
+            return index_ != nullptr;
+        }
+
+        auto get_allocator() const -> allocator_type {
+            return alloc_;
+        }
+
+        auto find(Key const& key) -> iterator {
+            return data_ + position(key);
+        }
+
+        auto find(Key const& key) const -> const_iterator {
+            return data_ + position(key);
+        }
+
+        auto count(Key const& key) const -> size_type {
+            return position(key) != size_ ? 1 : 0;
+        }
+
+        auto at(Key const& key) -> T& {
+            return const_cast<T&>(static_cast<FlatMap const&>(*this).at(key));
+        }
+
+        auto at(Key const& key) const -> T const& {
+            auto const pos = position(key);
+            if (pos == size_) {
+                throw std::out_of_range { "FlatMap::at: no such key" };
+            }
+
+            return data_[pos].second;
+        }
+
+        auto operator[](Key const& key) -> T& {
+            return try_emplace(key).first->second;
+        }
+
+        auto operator[](Key&& key) -> T& {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        // Constructs a `T` from `args` under `key`, unless `key` is already
+        // present, in which case nothing is constructed.
+        template<typename K, typename... Args>
+        auto try_emplace(K&& key, Args&&... args) -> std::pair<iterator, bool> {
+            auto const pos = position(key);
+            if (pos != size_) {
+                return { data_ + pos, false };
+            }
+
+            append(std::piecewise_construct,
+                   std::forward_as_tuple(std::forward<K>(key)),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+
+            if (index_) {
+                add_to_index(size_ - 1);
+            }
+            else if (size_ > IndexThreshold) {
+                build_index();
+            }
+
+            return { data_ + size_ - 1, true };
+        }
+
+        auto insert(value_type const& member) -> std::pair<iterator, bool> {
+            return try_emplace(member.first, member.second);
+        }
+
+        auto insert(value_type&& member) -> std::pair<iterator, bool> {
+            return try_emplace(
+                std::move(member.first), std::move(member.second));
+        }
+
+        auto erase(const_iterator pos) -> iterator {
+            auto* target = data_ + (pos - data_);
+            auto* last = data_ + size_ - 1;
+            if (Order == MemberOrder::Insertion) {
+                std::move(target + 1, last + 1, target);
+            }
+            else if (target != last) {
+                *target = std::move(*last);
+            }
+
+            Traits::destroy(alloc_, last);
+            --size_;
+            if (index_) {
+                build_index();
+            }
+
+            return target;
+        }
+
+        auto erase(Key const& key) -> size_type {
+            auto const it = find(key);
+            if (it == end()) {
+                return 0;
+            }
+
+            erase(it);
+            return 1;
+        }
+
+        auto clear() noexcept -> void {
+            for (size_t i = 0; i < size_; ++i) {
+                Traits::destroy(alloc_, data_ + i);
+            }
+
+            size_ = 0;
+            release_index();
+        }
+
+        auto reserve(size_type n) -> void {
+            if (n > capacity_) {
+                reallocate(n);
+            }
+        }
+
+    private:
+        using Traits = std::allocator_traits<allocator_type>;
+        using IndexAlloc = typename Traits::template rebind_alloc<std::uint32_t>;
+        using IndexTraits = std::allocator_traits<IndexAlloc>;
+        using InlineSlot = typename std::aligned_storage<
+            sizeof(value_type), alignof(value_type)>::type;
+
+        auto inline_data() noexcept -> value_type* {
+            return reinterpret_cast<value_type*>(inline_);
+        }
+
+        auto is_inline() const noexcept -> bool {
+            return data_ == reinterpret_cast<value_type const*>(inline_);
+        }
+
+        static auto hash(Key const& key) -> size_t {
+            return std::hash<Key> { }(key);
+        }
+
+        // The position of `key`, or `size_` if it isn't present.
+        auto position(Key const& key) const -> size_t {
+            if (!index_) {
+                for (size_t i = 0; i < size_; ++i) {
+                    if (data_[i].first == key) {
+                        return i;
+                    }
+                }
+
+                return size_;
+            }
+
+            auto const mask = index_capacity_ - 1;
+            for (auto slot = hash(key) & mask; index_[slot];
+                 slot = (slot + 1) & mask)
+            {
+                auto const pos = index_[slot] - 1;
+                if (data_[pos].first == key) {
+                    return pos;
+                }
+            }
+
+            return size_;
+        }
+
+        // Constructs the new member in fresh storage before moving the
+        // others across, so that arguments referring into the map stay
+        // valid.
+        template<typename... Args>
+        auto append(Args&&... args) -> void {
+            if (size_ < capacity_) {
+                Traits::construct(
+                    alloc_, data_ + size_, std::forward<Args>(args)...);
+                ++size_;
+                return;
+            }
+
+            auto const capacity = capacity_ * 2;
+            auto* data = Traits::allocate(alloc_, capacity);
+#ifndef VARIANT_NO_EXCEPTIONS
+            try {
+                Traits::construct(
+                    alloc_, data + size_, std::forward<Args>(args)...);
+            }
+            catch (...) {
+                Traits::deallocate(alloc_, data, capacity);
+                throw;
+            }
+#else
+            Traits::construct(
+                alloc_, data + size_, std::forward<Args>(args)...);
+#endif
+            relocate(data, capacity);
+            ++size_;
+        }
+
+        auto reallocate(size_t capacity) -> void {
+            relocate(Traits::allocate(alloc_, capacity), capacity);
+        }
+
+        // Moves the members into `data`, which takes over as the storage.
+        auto relocate(value_type* data, size_t capacity) -> void {
+            for (size_t i = 0; i < size_; ++i) {
+                Traits::construct(
+                    alloc_, data + i, std::move_if_noexcept(data_[i]));
+                Traits::destroy(alloc_, data_ + i);
+            }
+
+            if (!is_inline()) {
+                Traits::deallocate(alloc_, data_, capacity_);
+            }
+
+            data_ = data;
+            capacity_ = capacity;
+        }
+
+        // Leaves `other` empty, taking its storage when it is on the heap
+        // and can be freed by this map's allocator.
+        auto take(FlatMap& other) -> void {
+            if (!other.is_inline() && alloc_ == other.alloc_) {
+                data_ = other.data_;
+                size_ = other.size_;
+                capacity_ = other.capacity_;
+                index_ = other.index_;
+                index_capacity_ = other.index_capacity_;
+
+                other.data_ = other.inline_data();
+                other.size_ = 0;
+                other.capacity_ = InlineCapacity;
+                other.index_ = nullptr;
+                other.index_capacity_ = 0;
+                return;
+            }
+
+            reserve(other.size_);
+            for (auto& member : other) {
+                Traits::construct(alloc_, data_ + size_, std::move(member));
+                ++size_;
+            }
+
+            if (other.index_) {
+                build_index();
+            }
+
+            other.clear();
+        }
+
+        auto release_storage() noexcept -> void {
+            if (!is_inline()) {
+                Traits::deallocate(alloc_, data_, capacity_);
+                data_ = inline_data();
+                capacity_ = InlineCapacity;
+            }
+        }
+
+        auto release_index() noexcept -> void {
+            if (index_) {
+                IndexAlloc alloc { alloc_ };
+                IndexTraits::deallocate(alloc, index_, index_capacity_);
+                index_ = nullptr;
+                index_capacity_ = 0;
+            }
+        }
+
+        // Sizes the index to stay under half full, and fills it.
+        auto build_index() -> void {
+            release_index();
+
+            size_t capacity = 2 * IndexThreshold;
+            while (capacity < size_ * 2) {
+                capacity *= 2;
+            }
+
+            IndexAlloc alloc { alloc_ };
+            index_ = IndexTraits::allocate(alloc, capacity);
+            index_capacity_ = capacity;
+            std::fill(index_, index_ + capacity, std::uint32_t { 0 });
+
+            for (size_t i = 0; i < size_; ++i) {
+                add_to_index(i);
+            }
+        }
+
+        auto add_to_index(size_t pos) -> void {
+            if (size_ * 2 > index_capacity_) {
+                build_index();
+                return;
+            }
+
+            auto const mask = index_capacity_ - 1;
+            auto slot = hash(data_[pos].first) & mask;
+            while (index_[slot]) {
+                slot = (slot + 1) & mask;
+            }
+
+            index_[slot] = static_cast<std::uint32_t>(pos + 1);
+        }
+
+        allocator_type alloc_;
+        value_type* data_ = inline_data();
+        size_t size_ = 0;
+        size_t capacity_ = InlineCapacity;
+        // Positions plus one, with zero marking an empty slot
+        std::uint32_t* index_ = nullptr;
+        size_t index_capacity_ = 0;
+        InlineSlot inline_[InlineCapacity];
+    };
+}
+
+#endif //VARIANT_EXAMPLES_JSON_FLAT_MAP_HPP_INCLUDED
@@ -0,0 +1,786 @@
+#ifndef VARIANT_EXAMPLES_JSON_PARSE_HPP_INCLUDED
+#define VARIANT_EXAMPLES_JSON_PARSE_HPP_INCLUDED
+
+#include "json.hpp"
+#include "json_simd.hpp"
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace json {
+
+    struct ParseError : std::runtime_error {
+        ParseError(size_t offset, char const* what) :
+            std::runtime_error(
+                std::string { what } + " at offset " + std::to_string(offset)),
+            offset_ { offset }
+        { }
+
+        auto offset() const -> size_t {
+            return offset_;
+        }
+
+    private:
+        size_t offset_;
+    };
+
+    // One bit per byte of a 64 byte block, for each class of character
+    // the structural index cares about.
+    struct BlockMasks {
+        std::uint64_t quote;
+        std::uint64_t backslash;
+        std::uint64_t structural;
+        std::uint64_t whitespace;
+        std::uint64_t control;
+    };
+
+    struct ScalarScanner {
+        static auto scan(unsigned char const* block) -> BlockMasks {
+            BlockMasks m { };
+            for (unsigned i = 0; i < 64; ++i) {
+                auto const bit = std::uint64_t { 1 } << i;
+                switch (block[i]) {
+                case '"': m.quote |= bit; break;
+                case '\\': m.backslash |= bit; break;
+                case '{': case '}': case '[': case ']': case ',': case ':':
+                    m.structural |= bit;
+                    break;
+                case ' ': m.whitespace |= bit; break;
+                case '\t': case '\n': case '\r':
+                    m.whitespace |= bit;
+                    m.control |= bit;
+                    break;
+                default:
+                    if (block[i] < 0x20) {
+                        m.control |= bit;
+                    }
+                    break;
+                }
+            }
+
+            return m;
+        }
+    };
+
+#ifdef JSON_HAS_SSE2
+    struct Sse2Scanner {
+        static auto scan(unsigned char const* block) -> BlockMasks {
+            BlockMasks m { };
+            for (unsigned i = 0; i < 4; ++i) {
+                auto const v = _mm_loadu_si128(
+                    reinterpret_cast<__m128i const*>(block + i * 16));
+                auto const shift = i * 16;
+                m.quote |= mask(_mm_cmpeq_epi8(v, splat('"'))) << shift;
+                m.backslash |= mask(_mm_cmpeq_epi8(v, splat('\\'))) << shift;
+
+                // Setting bit 5 folds '[' and ']' onto '{' and '}'
+                auto const folded = _mm_or_si128(v, splat(0x20));
+                auto const structural = _mm_or_si128(
+                    _mm_or_si128(
+                        _mm_cmpeq_epi8(folded, splat('{')),
+                        _mm_cmpeq_epi8(folded, splat('}'))),
+                    _mm_or_si128(
+                        _mm_cmpeq_epi8(v, splat(',')),
+                        _mm_cmpeq_epi8(v, splat(':'))));
+                m.structural |= mask(structural) << shift;
+
+                auto const whitespace = _mm_or_si128(
+                    _mm_or_si128(
+                        _mm_cmpeq_epi8(v, splat(' ')),
+                        _mm_cmpeq_epi8(v, splat('\t'))),
+                    _mm_or_si128(
+                        _mm_cmpeq_epi8(v, splat('\n')),
+                        _mm_cmpeq_epi8(v, splat('\r'))));
+                m.whitespace |= mask(whitespace) << shift;
+
+                auto const control = _mm_cmpeq_epi8(
+                    _mm_min_epu8(v, splat(0x1f)), v);
+                m.control |= mask(control) << shift;
+            }
+
+            return m;
+        }
+
+    private:
+        static auto splat(char c) -> __m128i {
+            return _mm_set1_epi8(c);
+        }
+
+        static auto mask(__m128i v) -> std::uint64_t {
+            return static_cast<std::uint16_t>(_mm_movemask_epi8(v));
+        }
+    };
+#endif
+
+#ifdef JSON_HAS_AVX2
+    struct Avx2Scanner {
+        JSON_TARGET_AVX2
+        static auto scan(unsigned char const* block) -> BlockMasks {
+            BlockMasks m { };
+            for (unsigned i = 0; i < 2; ++i) {
+                auto const v = _mm256_loadu_si256(
+                    reinterpret_cast<__m256i const*>(block + i * 32));
+                auto const shift = i * 32;
+                m.quote |= mask(_mm256_cmpeq_epi8(v, splat('"'))) << shift;
+                m.backslash |=
+                    mask(_mm256_cmpeq_epi8(v, splat('\\'))) << shift;
+
+                auto const folded = _mm256_or_si256(v, splat(0x20));
+                auto const structural = _mm256_or_si256(
+                    _mm256_or_si256(
+                        _mm256_cmpeq_epi8(folded, splat('{')),
+                        _mm256_cmpeq_epi8(folded, splat('}'))),
+                    _mm256_or_si256(
+                        _mm256_cmpeq_epi8(v, splat(',')),
+                        _mm256_cmpeq_epi8(v, splat(':'))));
+                m.structural |= mask(structural) << shift;
+
+                auto const whitespace = _mm256_or_si256(
+                    _mm256_or_si256(
+                        _mm256_cmpeq_epi8(v, splat(' ')),
+                        _mm256_cmpeq_epi8(v, splat('\t'))),
+                    _mm256_or_si256(
+                        _mm256_cmpeq_epi8(v, splat('\n')),
+                        _mm256_cmpeq_epi8(v, splat('\r'))));
+                m.whitespace |= mask(whitespace) << shift;
+
+                auto const control = _mm256_cmpeq_epi8(
+                    _mm256_min_epu8(v, splat(0x1f)), v);
+                m.control |= mask(control) << shift;
+            }
+
+            return m;
+        }
+
+    private:
+        JSON_TARGET_AVX2
+        static auto splat(char c) -> __m256i {
+            return _mm256_set1_epi8(c);
+        }
+
+        JSON_TARGET_AVX2
+        static auto mask(__m256i v) -> std::uint64_t {
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+        }
+    };
+
+    inline auto has_avx2() -> bool {
+#if defined(__GNUC__) || defined(__clang__)
+        static bool const avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+#else
+        return true;
+#endif
+    }
+#endif
+
+    // Bit `i` of the result is the parity of bits 0..i of `bits`, which
+    // turns a mask of quotes into a mask of the bytes between them.
+    inline auto prefix_xor(std::uint64_t bits) -> std::uint64_t {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    // The bytes escaped by a backslash. Backslashes are rare, so they are
+    // walked one at a time rather than with carry-less arithmetic.
+    inline auto escaped_bytes(std::uint64_t backslash, bool& carry)
+        -> std::uint64_t
+    {
+        std::uint64_t escaped = 0;
+        if (carry) {
+            escaped = 1;
+            backslash &= ~std::uint64_t { 1 };
+            carry = false;
+        }
+
+        while (backslash) {
+            auto const i = trailing_zeros(backslash);
+            backslash &= backslash - 1;
+            if (i == 63) {
+                carry = true;
+                break;
+            }
+
+            auto const next = std::uint64_t { 1 } << (i + 1);
+            escaped |= next;
+            backslash &= ~next;
+        }
+
+        return escaped;
+    }
+
+    // Stage one: records the offset of every structural character, every
+    // unescaped quote and the first byte of every number or literal,
+    // 64 bytes at a time. The parser then only visits those offsets.
+    template<typename Scanner>
+    auto index_structurals(char const* data,
+                           size_t size,
+                           std::vector<std::uint32_t>& indices)
+        -> void
+    {
+        if (size > std::numeric_limits<std::uint32_t>::max()) {
+            throw ParseError { 0, "document too large" };
+        }
+
+        indices.clear();
+        indices.reserve(size / 6 + 8);
+
+        bool escape_carry = false;
+        std::uint64_t in_string_carry = 0;
+        std::uint64_t scalar_carry = 0;
+
+        auto const index_block = [&](unsigned char const* block,
+                                     std::uint32_t base)
+        {
+            auto const m = Scanner::scan(block);
+            auto const escaped = escaped_bytes(m.backslash, escape_carry);
+            auto const quotes = m.quote & ~escaped;
+            auto const in_string = prefix_xor(quotes) ^ in_string_carry;
+            in_string_carry =
+                static_cast<std::uint64_t>(
+                    static_cast<std::int64_t>(in_string) >> 63);
+
+            if (m.control & in_string & ~quotes) {
+                throw ParseError {
+                    base + trailing_zeros(m.control & in_string & ~quotes),
+                    "unescaped control character in string"
+                };
+            }
+
+            auto const scalar =
+                ~(m.structural | m.whitespace | m.quote | in_string);
+            auto const scalar_starts = scalar & ~((scalar << 1) | scalar_carry);
+            scalar_carry = scalar >> 63;
+
+            auto bits = (m.structural & ~in_string) | quotes | scalar_starts;
+            while (bits) {
+                indices.push_back(base + trailing_zeros(bits));
+                bits &= bits - 1;
+            }
+        };
+
+        auto const* bytes = reinterpret_cast<unsigned char const*>(data);
+        size_t offset = 0;
+        for (; offset + 64 <= size; offset += 64) {
+            index_block(bytes + offset, static_cast<std::uint32_t>(offset));
+        }
+
+        if (offset < size) {
+            unsigned char tail[64];
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, bytes + offset, size - offset);
+            index_block(tail, static_cast<std::uint32_t>(offset));
+        }
+
+        if (in_string_carry) {
+            throw ParseError { size, "unterminated string" };
+        }
+    }
+
+    inline auto append_utf8(std::string& out, std::uint32_t code_point)
+        -> void
+    {
+        if (code_point < 0x80) {
+            out += static_cast<char>(code_point);
+        }
+        else if (code_point < 0x800) {
+            out += static_cast<char>(0xc0 | (code_point >> 6));
+            out += static_cast<char>(0x80 | (code_point & 0x3f));
+        }
+        else if (code_point < 0x10000) {
+            out += static_cast<char>(0xe0 | (code_point >> 12));
+            out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code_point & 0x3f));
+        }
+        else {
+            out += static_cast<char>(0xf0 | (code_point >> 18));
+            out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code_point & 0x3f));
+        }
+    }
+
+    // Stage two: builds the tree from the structural index, constructing
+    // each value directly in the container that holds it.
+    struct Parser {
+        static constexpr size_t max_depth = 1024;
+
+        Parser(char const* data,
+               size_t size,
+               std::vector<std::uint32_t> const& indices)
+        :
+            data_ { data },
+            size_ { size },
+            indices_ { indices }
+        { }
+
+        auto parse_document() -> JsonValue {
+            JsonValue root = null();
+            parse_value(0, RootSink { root });
+
+            if (next_ != indices_.size()) {
+                fail(indices_[next_], "unexpected content after document");
+            }
+
+            return root;
+        }
+
+    private:
+        // Where a parsed value goes. Each constructs the value in place
+        // from `variant::in_place_type<T>` and its constructor arguments.
+        // These are concrete types, rather than lambdas, so that nesting
+        // doesn't instantiate a new `parse_value` per level.
+        struct RootSink {
+            template<typename T, typename... Args>
+            auto operator()(variant::in_place_type_t<T>, Args&&... args) 
+                -> void 
+            {
+                root.emplace<T>(std::forward<Args>(args)...);
+            }
+
+            JsonValue& root;
+        };
+
+        struct ArraySink {
+            template<typename T, typename... Args>
+            auto operator()(variant::in_place_type_t<T> tag, Args&&... args) 
+                -> void 
+            {
+                values.emplace_back(tag, std::forward<Args>(args)...);
+            }
+
+            decltype(JsonArray::values)& values;
+        };
+
+        struct ObjectSink {
+            template<typename T, typename... Args>
+            auto operator()(variant::in_place_type_t<T> tag, Args&&... args) 
+                -> void 
+            {
+                members.try_emplace(
+                    std::move(key), tag, std::forward<Args>(args)...);
+            }
+
+            JsonMembers& members;
+            std::string& key;
+        };
+
+        [[noreturn]] static auto fail(size_t offset, char const* what)
+            -> void
+        {
+            throw ParseError { offset, what };
+        }
+
+        auto take() -> size_t {
+            if (next_ == indices_.size()) {
+                fail(size_, "unexpected end of input");
+            }
+
+            return indices_[next_++];
+        }
+
+        auto peek() const -> char {
+            return next_ == indices_.size() ? '\0' : data_[indices_[next_]];
+        }
+
+        template<typename Sink>
+        auto parse_value(size_t depth, Sink emplace) -> void {
+            auto const pos = take();
+            switch (data_[pos]) {
+            case '{':
+                return parse_object(pos, depth, emplace);
+            case '[':
+                return parse_array(pos, depth, emplace);
+            case '"':
+                return emplace(
+                    variant::in_place_type<JsonString>, parse_string(pos));
+            case 't':
+                expect_literal(pos, "true");
+                return emplace(variant::in_place_type<JsonBool>, true);
+            case 'f':
+                expect_literal(pos, "false");
+                return emplace(variant::in_place_type<JsonBool>, false);
+            case 'n':
+                expect_literal(pos, "null");
+                return emplace(variant::in_place_type<JsonNull>);
+            default:
+                return emplace(
+                    variant::in_place_type<JsonNumber>, parse_number(pos));
+            }
+        }
+
+        template<typename Sink>
+        auto parse_array(size_t pos, size_t depth, Sink& emplace)
+            -> void
+        {
+            if (depth == max_depth) {
+                fail(pos, "document nested too deeply");
+            }
+
+            JsonArrayProxy array { JsonArray { } };
+            auto& values = array->values;
+            if (peek() == ']') {
+                ++next_;
+                return emplace(
+                    variant::in_place_type<JsonArrayProxy>, std::move(array));
+            }
+
+            for (;;) {
+                parse_value(depth + 1, ArraySink { values });
+
+                auto const sep = take();
+                if (data_[sep] == ']') {
+                    break;
+                }
+                if (data_[sep] != ',') {
+                    fail(sep, "expected ',' or ']'");
+                }
+            }
+
+            emplace(variant::in_place_type<JsonArrayProxy>, std::move(array));
+        }
+
+        template<typename Sink>
+        auto parse_object(size_t pos, size_t depth, Sink& emplace)
+            -> void
+        {
+            if (depth == max_depth) {
+                fail(pos, "document nested too deeply");
+            }
+
+            JsonObjectProxy object { JsonObject() };
+            auto& members = object->members;
+            if (peek() == '}') {
+                ++next_;
+                return emplace(
+                    variant::in_place_type<JsonObjectProxy>,
+                    std::move(object));
+            }
+
+            for (;;) {
+                auto const key_pos = take();
+                if (data_[key_pos] != '"') {
+                    fail(key_pos, "expected a string key");
+                }
+                auto key = parse_string(key_pos);
+
+                auto const colon = take();
+                if (data_[colon] != ':') {
+                    fail(colon, "expected ':'");
+                }
+
+                parse_value(depth + 1, ObjectSink { members, key });
+
+                auto const sep = take();
+                if (data_[sep] == '}') {
+                    break;
+                }
+                if (data_[sep] != ',') {
+                    fail(sep, "expected ',' or '}'");
+                }
+            }
+
+            emplace(
+                variant::in_place_type<JsonObjectProxy>, std::move(object));
+        }
+
+        // Strings without escapes are copied straight out of the input;
+        // the rest are decoded a run at a time between backslashes.
+        auto parse_string(size_t open) -> std::string {
+            auto const close = take();
+            auto const* first = data_ + open + 1;
+            auto const* last = data_ + close;
+
+            auto const* backslash = static_cast<char const*>(
+                std::memchr(first, '\\', static_cast<size_t>(last - first)));
+            if (!backslash) {
+                return std::string(first, last);
+            }
+
+            std::string out;
+            out.reserve(static_cast<size_t>(last - first));
+            while (backslash) {
+                out.append(first, backslash);
+                first = decode_escape(backslash, last, out);
+                backslash = static_cast<char const*>(
+                    std::memchr(first, '\\', static_cast<size_t>(last - first)));
+            }
+            out.append(first, last);
+
+            return out;
+        }
+
+        auto decode_escape(char const* p, char const* last, std::string& out)
+            -> char const*
+        {
+            switch (p[1]) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                auto code_point = parse_hex4(p + 2, last);
+                p += 6;
+                if (code_point >= 0xd800 && code_point < 0xdc00) {
+                    if (last - p < 6 || p[0] != '\\' || p[1] != 'u') {
+                        fail(offset(p), "unpaired surrogate");
+                    }
+                    auto const low = parse_hex4(p + 2, last);
+                    if (low < 0xdc00 || low >= 0xe000) {
+                        fail(offset(p), "invalid low surrogate");
+                    }
+                    code_point =
+                        0x10000 + ((code_point - 0xd800) << 10) +
+                            (low - 0xdc00);
+                    p += 6;
+                }
+                else if (code_point >= 0xdc00 && code_point < 0xe000) {
+                    fail(offset(p), "unpaired surrogate");
+                }
+                append_utf8(out, code_point);
+                return p;
+            }
+            default:
+                fail(offset(p), "invalid escape");
+            }
+
+            return p + 2;
+        }
+
+        auto parse_hex4(char const* p, char const* last) -> std::uint32_t {
+            if (last - p < 4) {
+                fail(offset(p), "truncated \\u escape");
+            }
+
+            std::uint32_t value = 0;
+            for (int i = 0; i < 4; ++i) {
+                auto const c = p[i];
+                value <<= 4;
+                if (c >= '0' && c <= '9') {
+                    value |= static_cast<std::uint32_t>(c - '0');
+                }
+                else if (c >= 'a' && c <= 'f') {
+                    value |= static_cast<std::uint32_t>(c - 'a' + 10);
+                }
+                else if (c >= 'A' && c <= 'F') {
+                    value |= static_cast<std::uint32_t>(c - 'A' + 10);
+                }
+                else {
+                    fail(offset(p + i), "invalid \\u escape");
+                }
+            }
+
+            return value;
+        }
+
+        auto expect_literal(size_t pos, char const* literal) -> void {
+            auto const length = std::strlen(literal);
+            if (size_ - pos < length ||
+                std::memcmp(data_ + pos, literal, length) != 0 ||
+                !ends_scalar(pos + length))
+            {
+                fail(pos, "invalid literal");
+            }
+        }
+
+        // Whether a number or literal may end just before `pos`.
+        auto ends_scalar(size_t pos) const -> bool {
+            if (pos == size_) {
+                return true;
+            }
+
+            switch (data_[pos]) {
+            case ' ': case '\t': case '\n': case '\r':
+            case ',': case ':': case '[': case ']': case '{': case '}':
+            case '"':
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        static auto is_digit(char c) -> bool {
+            return c >= '0' && c <= '9';
+        }
+
+        // Numbers with at most 19 significant digits whose mantissa and
+        // power of ten are both exactly representable are converted with
+        // a single multiply or divide, which is correctly rounded. Anything
+        // else goes through `strtod`, with the '.' swapped for the current
+        // locale's decimal point. Numbers too large for a double are an
+        // error; those too small round to zero.
+        auto parse_number(size_t pos) -> double {
+            static constexpr double powers_of_ten[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+                1e21, 1e22
+            };
+
+            auto const* p = data_ + pos;
+            auto const* end = data_ + size_;
+            bool const negative = p != end && *p == '-';
+            if (negative) {
+                ++p;
+            }
+
+            if (p == end || !is_digit(*p)) {
+                fail(pos, "invalid number");
+            }
+
+            std::uint64_t mantissa = 0;
+            int digits = 0;
+            int exponent = 0;
+            bool truncated = false;
+
+            auto const add_digit = [&](char c, bool fraction) {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + static_cast<unsigned>(c - '0');
+                    digits += mantissa != 0;
+                    exponent -= fraction;
+                }
+                else {
+                    truncated = true;
+                    exponent += !fraction;
+                }
+            };
+
+            if (*p == '0') {
+                ++p;
+            }
+            else {
+                while (p != end && is_digit(*p)) {
+                    add_digit(*p++, false);
+                }
+            }
+
+            if (p != end && *p == '.') {
+                ++p;
+                if (p == end || !is_digit(*p)) {
+                    fail(offset(p), "invalid number");
+                }
+                while (p != end && is_digit(*p)) {
+                    add_digit(*p++, true);
+                }
+            }
+
+            if (p != end && (*p == 'e' || *p == 'E')) {
+                ++p;
+                bool const negative_exponent = p != end && *p == '-';
+                if (p != end && (*p == '-' || *p == '+')) {
+                    ++p;
+                }
+                if (p == end || !is_digit(*p)) {
+                    fail(offset(p), "invalid number");
+                }
+
+                int explicit_exponent = 0;
+                while (p != end && is_digit(*p)) {
+                    if (explicit_exponent < 100000) {
+                        explicit_exponent =
+                            explicit_exponent * 10 + (*p - '0');
+                    }
+                    ++p;
+                }
+                exponent +=
+                    negative_exponent ? -explicit_exponent : explicit_exponent;
+            }
+
+            auto const last = static_cast<size_t>(p - data_);
+            if (!ends_scalar(last)) {
+                fail(last, "invalid number");
+            }
+
+            if (!truncated &&
+                mantissa <= (std::uint64_t { 1 } << 53) &&
+                exponent >= -22 && exponent <= 22)
+            {
+                auto value = static_cast<double>(mantissa);
+                value = exponent < 0
+                    ? value / powers_of_ten[-exponent]
+                    : value * powers_of_ten[exponent];
+                return negative ? -value : value;
+            }
+
+            std::string text { data_ + pos, p };
+            auto const point = text.find('.');
+            if (point != std::string::npos) {
+                text[point] = *std::localeconv()->decimal_point;
+            }
+
+            auto const value = std::strtod(text.c_str(), nullptr);
+            if (std::isinf(value)) {
+                fail(pos, "number out of range");
+            }
+
+            return value;
+        }
+
+        auto offset(char const* p) const -> size_t {
+            return static_cast<size_t>(p - data_);
+        }
+
+        char const* data_;
+        size_t size_;
+        std::vector<std::uint32_t> const& indices_;
+        size_t next_ = 0;
+    };
+
+    // Parses a complete JSON document using `Scanner` to build the
+    // structural index. Throws `ParseError` on malformed input.
+    template<typename Scanner>
+    auto parse_with(char const* data, size_t size) -> JsonValue {
+        std::vector<std::uint32_t> indices;
+        index_structurals<Scanner>(data, size, indices);
+        return Parser { data, size, indices }.parse_document();
+    }
+
+    // Parses with the widest scanner this machine supports.
+    inline auto parse(char const* data, size_t size) -> JsonValue {
+#if defined(JSON_HAS_AVX2)
+        if (has_avx2()) {
+            return parse_with<Avx2Scanner>(data, size);
+        }
+#endif
+#if defined(JSON_HAS_SSE2)
+        return parse_with<Sse2Scanner>(data, size);
+#else
+        return parse_with<ScalarScanner>(data, size);
+#endif
+    }
+
+    inline auto parse(std::string const& text) -> JsonValue {
+        return parse(text.data(), text.size());
+    }
+
+    inline auto parse(char const* text) -> JsonValue {
+        return parse(text, std::strlen(text));
+    }
+
+#if __cplusplus >= 201703L
+    inline auto parse(std::string_view text) -> JsonValue {
+        return parse(text.data(), text.size());
+    }
+#endif
+}
+
+#endif //VARIANT_EXAMPLES_JSON_PARSE_HPP_INCLUDED
@@ -0,0 +1,43 @@
+#ifndef VARIANT_EXAMPLES_JSON_SIMD_HPP_INCLUDED
+#define VARIANT_EXAMPLES_JSON_SIMD_HPP_INCLUDED
+
+#include <cstdint>
+
+// Define JSON_NO_SIMD to build only the portable scanner.
+#if !defined(JSON_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define JSON_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+// GCC and Clang can compile the AVX2 scanner without -mavx2 and pick it
+// at runtime; elsewhere it is only built when AVX2 is already enabled.
+#if defined(JSON_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define JSON_HAS_AVX2
+#define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(JSON_HAS_SSE2) && defined(__AVX2__)
+#define JSON_HAS_AVX2
+#define JSON_TARGET_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace json {
+
+    inline auto trailing_zeros(std::uint64_t bits) -> unsigned {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+    }
+}
+
+#endif //VARIANT_EXAMPLES_JSON_SIMD_HPP_INCLUDED
@@ -0,0 +1,335 @@
+#ifndef VARIANT_EXAMPLES_JSON_WRITE_HPP_INCLUDED
+#define VARIANT_EXAMPLES_JSON_WRITE_HPP_INCLUDED
+
+#include "json.hpp"
+#include "json_simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#if defined(__cpp_lib_to_chars)
+#define JSON_HAS_TO_CHARS
+#endif
+#endif
+#endif
+
+namespace json {
+
+    // A contiguous, growable output buffer. Given a `FILE*`, it instead
+    // writes through to the file each time `chunk` bytes have built up, so
+    // memory use stays bounded however large the document.
+    struct OutputBuffer {
+        OutputBuffer() = default;
+
+        explicit OutputBuffer(std::FILE* file, size_t chunk = 1 << 16) :
+            data_ { new char[chunk] },
+            capacity_ { chunk },
+            file_ { file }
+        { }
+
+        OutputBuffer(OutputBuffer const&) = delete;
+        OutputBuffer& operator=(OutputBuffer const&) = delete;
+
+        // Anything not yet flushed to the file is written on a best effort
+        // basis; call `flush()` to find out if it failed.
+        ~OutputBuffer() {
+            if (file_) {
+                write_out();
+            }
+        }
+
+        auto append(char const* s, size_t n) -> void {
+            std::memcpy(reserve(n), s, n);
+            size_ += n;
+        }
+
+        auto put(char c) -> void {
+            *reserve(1) = c;
+            ++size_;
+        }
+
+        // Makes room for at least `n` more bytes at the returned pointer.
+        // Claim the bytes actually written with `commit()`.
+        auto reserve(size_t n) -> char* {
+            if (capacity_ - size_ < n) {
+                make_room(n);
+            }
+
+            return data_.get() + size_;
+        }
+
+        auto commit(size_t n) -> void {
+            size_ += n;
+        }
+
+        auto data() const -> char const* {
+            return data_.get();
+        }
+
+        auto size() const -> size_t {
+            return size_;
+        }
+
+        auto str() const -> std::string {
+            return std::string(data_.get(), size_);
+        }
+
+        auto clear() -> void {
+            size_ = 0;
+        }
+
+        // Writes everything buffered so far to the file, if there is one.
+        auto flush() -> void {
+            if (file_ && (!write_out() || std::fflush(file_) != 0)) {
+                throw std::runtime_error { "failed to write JSON output" };
+            }
+        }
+
+    private:
+        auto write_out() -> bool {
+            auto const size = size_;
+            size_ = 0;
+            return std::fwrite(data_.get(), 1, size, file_) == size;
+        }
+
+        auto make_room(size_t n) -> void {
+            if (file_) {
+                flush();
+                if (capacity_ >= n) {
+                    return;
+                }
+            }
+
+            auto const capacity =
+                std::max({ capacity_ * 2, size_ + n, size_t { 256 } });
+            std::unique_ptr<char[]> data { new char[capacity] };
+            if (size_) {
+                std::memcpy(data.get(), data_.get(), size_);
+            }
+
+            data_ = std::move(data);
+            capacity_ = capacity;
+        }
+
+        std::unique_ptr<char[]> data_;
+        size_t size_ = 0;
+        size_t capacity_ = 0;
+        std::FILE* file_ = nullptr;
+    };
+
+    // Enough for any double, in either format below.
+    constexpr size_t max_number_chars = 32;
+
+    // Writes the shortest text that reads back as exactly `v`. JSON has
+    // no infinities or NaN, so they are written as `null`.
+    inline auto format_number(double v, char* out) -> size_t {
+        if (!std::isfinite(v)) {
+            std::memcpy(out, "null", 4);
+            return 4;
+        }
+
+        // Whole numbers that a double holds exactly are by far the most
+        // common, and need no floating point formatting at all.
+        if (v == std::floor(v) && std::fabs(v) < 9007199254740992.0) {
+            char digits[20];
+            char* p = digits + sizeof(digits);
+            auto n = static_cast<std::uint64_t>(std::fabs(v));
+            do {
+                *--p = static_cast<char>('0' + n % 10);
+                n /= 10;
+            }
+            while (n);
+
+            size_t length = 0;
+            if (std::signbit(v)) {
+                out[length++] = '-';
+            }
+
+            auto const count = static_cast<size_t>(digits + sizeof(digits) - p);
+            std::memcpy(out + length, p, count);
+            return length + count;
+        }
+
+#ifdef JSON_HAS_TO_CHARS
+        return static_cast<size_t>(
+            std::to_chars(out, out + max_number_chars, v).ptr - out);
+#else
+        // Without `to_chars`, try increasing precision until the text reads
+        // back exactly. This relies on the C library's "C" locale, which
+        // is in force unless the program calls `setlocale`.
+        for (int precision = 15; precision < 17; ++precision) {
+            auto const length =
+                std::snprintf(out, max_number_chars, "%.*g", precision, v);
+            if (std::strtod(out, nullptr) == v) {
+                return static_cast<size_t>(length);
+            }
+        }
+
+        return static_cast<size_t>(
+            std::snprintf(out, max_number_chars, "%.17g", v));
+#endif
+    }
+
+    inline auto needs_escape(unsigned char c) -> bool {
+        return c == '"' || c == '\\' || c < 0x20;
+    }
+
+    // The number of bytes at the start of [p, end) that can be copied
+    // through as they are. Strings are mostly plain text, so this checks
+    // 16 bytes at a time where it can.
+    inline auto plain_run(char const* p, char const* end) -> size_t {
+        auto const begin = p;
+#ifdef JSON_HAS_SSE2
+        auto const quote = _mm_set1_epi8('"');
+        auto const backslash = _mm_set1_epi8('\\');
+        auto const control = _mm_set1_epi8(0x1f);
+        while (end - p >= 16) {
+            auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+            auto const special = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_cmpeq_epi8(v, quote),
+                    _mm_cmpeq_epi8(v, backslash)),
+                _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+
+            auto const mask =
+                static_cast<std::uint32_t>(_mm_movemask_epi8(special));
+            if (mask) {
+                return static_cast<size_t>(p - begin) + trailing_zeros(mask);
+            }
+
+            p += 16;
+        }
+#endif
+        while (p != end && !needs_escape(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+
+        return static_cast<size_t>(p - begin);
+    }
+
+    inline auto write_escape(OutputBuffer& out, unsigned char c) -> void {
+        char const* escape = nullptr;
+        switch (c) {
+        case '"': escape = "\\\""; break;
+        case '\\': escape = "\\\\"; break;
+        case '\b': escape = "\\b"; break;
+        case '\f': escape = "\\f"; break;
+        case '\n': escape = "\\n"; break;
+        case '\r': escape = "\\r"; break;
+        case '\t': escape = "\\t"; break;
+        default: {
+            static char const hex[] = "0123456789abcdef";
+            char const unicode[] = {
+                '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]
+            };
+            out.append(unicode, sizeof(unicode));
+            return;
+        }
+        }
+
+        out.append(escape, 2);
+    }
+
+    inline auto write_string(OutputBuffer& out, std::string const& s) -> void {
+        out.put('"');
+        auto p = s.data();
+        auto const end = p + s.size();
+        while (p != end) {
+            auto const n = plain_run(p, end);
+            out.append(p, n);
+            p += n;
+            if (p != end) {
+                write_escape(out, static_cast<unsigned char>(*p++));
+            }
+        }
+
+        out.put('"');
+    }
+
+    // Writes compact JSON, with no whitespace between tokens.
+    struct JsonWriter {
+        auto operator()(JsonString const& s) const -> void {
+            write_string(out, s.value);
+        }
+
+        auto operator()(JsonNumber const& n) const -> void {
+            out.commit(format_number(n.value, out.reserve(max_number_chars)));
+        }
+
+        auto operator()(JsonBool const& b) const -> void {
+            if (b.value) {
+                out.append("true", 4);
+            }
+            else {
+                out.append("false", 5);
+            }
+        }
+
+        auto operator()(JsonArrayProxy const& a) const -> void {
+            out.put('[');
+            bool first = true;
+            for (auto const& value : a->values) {
+                if (!first) {
+                    out.put(',');
+                }
+
+                first = false;
+                variant::visit(*this, value);
+            }
+
+            out.put(']');
+        }
+
+        auto operator()(JsonObjectProxy const& o) const -> void {
+            out.put('{');
+            bool first = true;
+            for (auto const& member : o->members) {
+                if (!first) {
+                    out.put(',');
+                }
+
+                first = false;
+                write_string(out, member.first);
+                out.put(':');
+                variant::visit(*this, member.second);
+            }
+
+            out.put('}');
+        }
+
+        auto operator()(JsonNull const&) const -> void {
+            out.append("null", 4);
+        }
+
+        OutputBuffer& out;
+    };
+
+    inline auto serialize(JsonValue const& value, OutputBuffer& out) -> void {
+        variant::visit(JsonWriter { out }, value);
+    }
+
+    inline auto serialize(JsonValue const& value) -> std::string {
+        OutputBuffer out;
+        serialize(value, out);
+        return out.str();
+    }
+
+    // Writes `value` to `file` in large chunks, throwing if any write
+    // fails. For a file descriptor, wrap it with `fdopen` first.
+    inline auto write(std::FILE* file, JsonValue const& value) -> void {
+        OutputBuffer out { file };
+        serialize(value, out);
+        out.flush();
+    }
+}
+
+#endif //VARIANT_EXAMPLES_JSON_WRITE_HPP_INCLUDED
@@ -0,0 +1,452 @@
+#ifndef VARIANT_ATOMIC_HPP_INCLUDED
+#define VARIANT_ATOMIC_HPP_INCLUDED
+
+#include "variant/variant.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+// Compilers that can zero a value's padding bits let `AtomicVariant`
+// compare values rather than whatever their padding happened to hold.
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_clear_padding)
+#define VARIANT_HAS_CLEAR_PADDING
+#endif
+#endif
+
+// A 16 byte compare-and-swap, e.g. `cmpxchg16b` on x86-64 when built with
+// `-mcx16`.
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) && \
+    !defined(VARIANT_NO_DOUBLE_WORD_CAS)
+#define VARIANT_HAS_DOUBLE_WORD_CAS
+#endif
+
+namespace variant {
+
+    // How an `AtomicVariant` keeps its value. `Word` uses a single native
+    // atomic and suits variants of up to 8 bytes; `DoubleWord` uses a
+    // 16 byte compare-and-swap for every operation, loads included;
+    // `SeqLock` serialises writers and lets readers retry any read that
+    // overlapped a write, so it suits any size.
+    enum class AtomicStrategy { Word, DoubleWord, SeqLock };
+
+    template<size_t Size>
+    constexpr auto default_atomic_strategy() -> AtomicStrategy {
+#ifdef VARIANT_HAS_DOUBLE_WORD_CAS
+        return Size <= 8 ? AtomicStrategy::Word
+             : Size <= 16 ? AtomicStrategy::DoubleWord
+             : AtomicStrategy::SeqLock;
+#else
+        return Size <= 8 ? AtomicStrategy::Word : AtomicStrategy::SeqLock;
+#endif
+    }
+
+    template<size_t Size, AtomicStrategy Strategy>
+    struct AtomicStorage;
+
+    template<size_t Size>
+    using atomic_word_t =
+        std::conditional_t<
+            Size <= 1, std::uint8_t,
+            std::conditional_t<
+                Size <= 2, std::uint16_t,
+                std::conditional_t<
+                    Size <= 4, std::uint32_t, std::uint64_t>>>;
+
+    template<size_t Size>
+    struct AtomicStorage<Size, AtomicStrategy::Word> {
+        static_assert(Size <= sizeof(std::uint64_t),
+            "Word storage holds at most 8 bytes");
+
+        using Word = atomic_word_t<Size>;
+
+        explicit AtomicStorage(void const* initial) :
+            word_ { to_word(initial) }
+        { }
+
+        auto is_lock_free() const -> bool {
+            return word_.is_lock_free();
+        }
+
+        auto load(void* out, std::memory_order order) const -> void {
+            auto const word = word_.load(order);
+            std::memcpy(out, &word, Size);
+        }
+
+        auto store(void const* in, std::memory_order order) -> void {
+            word_.store(to_word(in), order);
+        }
+
+        auto exchange(void const* in, void* out, std::memory_order order)
+            -> void
+        {
+            auto const word = word_.exchange(to_word(in), order);
+            std::memcpy(out, &word, Size);
+        }
+
+        auto compare_exchange(void* expected,
+                              void const* desired,
+                              bool weak,
+                              std::memory_order success,
+                              std::memory_order failure) -> bool
+        {
+            auto current = to_word(expected);
+            auto const exchanged = weak
+                ? word_.compare_exchange_weak(
+                    current, to_word(desired), success, failure)
+                : word_.compare_exchange_strong(
+                    current, to_word(desired), success, failure);
+            std::memcpy(expected, &current, Size);
+            return exchanged;
+        }
+
+    private:
+        static auto to_word(void const* in) -> Word {
+            Word word = 0;
+            std::memcpy(&word, in, Size);
+            return word;
+        }
+
+        std::atomic<Word> word_;
+    };
+
+#ifdef VARIANT_HAS_DOUBLE_WORD_CAS
+    template<size_t Size>
+    struct AtomicStorage<Size, AtomicStrategy::DoubleWord> {
+        static_assert(Size <= 16, "DoubleWord storage holds at most 16 bytes");
+
+        __extension__ typedef unsigned __int128 DoubleWord;
+
+        explicit AtomicStorage(void const* initial) :
+            value_ { to_double_word(initial) }
+        { }
+
+        auto is_lock_free() const -> bool {
+            return true;
+        }
+
+        // A load is a compare-and-swap that can't change anything, so
+        // readers contend for the cache line just as writers do.
+        auto load(void* out, std::memory_order) const -> void {
+            auto const value = __sync_val_compare_and_swap(&value_, 0, 0);
+            std::memcpy(out, &value, Size);
+        }
+
+        auto store(void const* in, std::memory_order order) -> void {
+            DoubleWord previous;
+            exchange(in, &previous, order);
+        }
+
+        auto exchange(void const* in, void* out, std::memory_order) -> void {
+            // Start from a guess rather than a plain read of `value_`, 
+            // which could tear; a wrong guess just fails the first 
+            // compare-and-swap, which then returns the real value.
+            auto const desired = to_double_word(in);
+            DoubleWord current = 0;
+            for (;;) {
+                auto const seen =
+                    __sync_val_compare_and_swap(&value_, current, desired);
+                if (seen == current) {
+                    break;
+                }
+                current = seen;
+            }
+            std::memcpy(out, &current, Size);
+        }
+
+        auto compare_exchange(void* expected,
+                              void const* desired,
+                              bool,
+                              std::memory_order,
+                              std::memory_order) -> bool
+        {
+            auto const current = to_double_word(expected);
+            auto const seen = __sync_val_compare_and_swap(
+                &value_, current, to_double_word(desired));
+            std::memcpy(expected, &seen, Size);
+            return seen == current;
+        }
+
+    private:
+        static auto to_double_word(void const* in) -> DoubleWord {
+            DoubleWord value = 0;
+            std::memcpy(&value, in, Size);
+            return value;
+        }
+
+        alignas(16) mutable DoubleWord value_;
+    };
+#endif
+
+    // A sequence lock: the count is odd while a writer is active, and
+    // readers retry if it was odd or changed while they read. The payload
+    // is held in relaxed atomic words so that a read racing a write is
+    // merely discarded rather than undefined.
+    template<size_t Size>
+    struct AtomicStorage<Size, AtomicStrategy::SeqLock> {
+        explicit AtomicStorage(void const* initial) :
+            sequence_ { 0 }
+        {
+            write_words(initial);
+        }
+
+        auto is_lock_free() const -> bool {
+            return false;
+        }
+
+        auto load(void* out, std::memory_order) const -> void {
+            std::uint64_t copy[word_count];
+            for (;;) {
+                auto const before = sequence_.load(std::memory_order_acquire);
+                if (before & 1) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                for (size_t i = 0; i < word_count; ++i) {
+                    copy[i] = words_[i].load(std::memory_order_relaxed);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence_.load(std::memory_order_relaxed) == before) {
+                    break;
+                }
+            }
+
+            std::memcpy(out, copy, Size);
+        }
+
+        auto store(void const* in, std::memory_order) -> void {
+            auto const sequence = lock();
+            write_words(in);
+            unlock(sequence);
+        }
+
+        auto exchange(void const* in, void* out, std::memory_order) -> void {
+            auto const sequence = lock();
+            read_words(out);
+            write_words(in);
+            unlock(sequence);
+        }
+
+        auto compare_exchange(void* expected,
+                              void const* desired,
+                              bool,
+                              std::memory_order,
+                              std::memory_order) -> bool
+        {
+            unsigned char current[Size];
+            auto const sequence = lock();
+            read_words(current);
+            auto const matches = std::memcmp(current, expected, Size) == 0;
+            if (matches) {
+                write_words(desired);
+            }
+            unlock(sequence);
+
+            if (!matches) {
+                std::memcpy(expected, current, Size);
+            }
+
+            return matches;
+        }
+
+    private:
+        static constexpr size_t word_count =
+            (Size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        auto lock() -> std::uint64_t {
+            for (;;) {
+                auto sequence = sequence_.load(std::memory_order_relaxed);
+                if (!(sequence & 1) &&
+                    sequence_.compare_exchange_weak(
+                        sequence,
+                        sequence + 1,
+                        std::memory_order_acquire))
+                {
+                    // Readers that see any of the new words must also see
+                    // the odd count.
+                    std::atomic_thread_fence(std::memory_order_release);
+                    return sequence;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+        auto unlock(std::uint64_t sequence) -> void {
+            sequence_.store(sequence + 2, std::memory_order_release);
+        }
+
+        // Only called by the writer holding the lock.
+        auto read_words(void* out) const -> void {
+            std::uint64_t copy[word_count];
+            for (size_t i = 0; i < word_count; ++i) {
+                copy[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::memcpy(out, copy, Size);
+        }
+
+        auto write_words(void const* in) -> void {
+            std::uint64_t copy[word_count] = { };
+            std::memcpy(copy, in, Size);
+            for (size_t i = 0; i < word_count; ++i) {
+                words_[i].store(copy[i], std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<std::uint64_t> sequence_;
+        std::atomic<std::uint64_t> words_[word_count];
+    };
+
+    template<typename T>
+    auto clear_padding(T& val) -> void {
+#ifdef VARIANT_HAS_CLEAR_PADDING
+        __builtin_clear_padding(&val);
+#else
+        (void)val;
+#endif
+    }
+
+    // Rebuilds alternative `K` of a variant in zeroed memory, so that the
+    // bytes of inactive alternatives (and, where the compiler can clear
+    // it, padding) don't take part in comparisons.
+    template<typename V>
+    struct CanonicalCopy {
+        using Fn = auto (*)(V const&, void*) -> void;
+
+        template<size_t K>
+        static auto call(V const& v, void* out) -> void {
+            auto val = v.template unsafe_get<K>();
+            clear_padding(val);
+            ::new (out) V { in_place_index<K>, val };
+        }
+    };
+
+    // A `Variant` of trivially copyable alternatives that can be loaded,
+    // stored and compare-exchanged as a whole from several threads at
+    // once. Compare-exchange compares the bytes of the active alternative,
+    // like `std::atomic` does.
+    template<AtomicStrategy Strategy, typename... Ts>
+    struct BasicAtomicVariant {
+        using value_type = Variant<Ts...>;
+
+        static_assert(std::is_trivially_copyable<value_type>::value,
+            "AtomicVariant alternatives must be trivially copyable");
+
+        static constexpr AtomicStrategy strategy = Strategy;
+
+        explicit BasicAtomicVariant(value_type const& initial) :
+            storage_ { Canonical { initial }.bytes }
+        { }
+
+        BasicAtomicVariant(BasicAtomicVariant const&) = delete;
+        BasicAtomicVariant& operator=(BasicAtomicVariant const&) = delete;
+
+        auto is_lock_free() const -> bool {
+            return storage_.is_lock_free();
+        }
+
+        auto load(std::memory_order order = std::memory_order_seq_cst) const
+            -> value_type
+        {
+            Canonical out;
+            storage_.load(out.bytes, order);
+            return out.value();
+        }
+
+        auto store(value_type const& val,
+                   std::memory_order order = std::memory_order_seq_cst)
+            -> void
+        {
+            storage_.store(Canonical { val }.bytes, order);
+        }
+
+        auto exchange(value_type const& val,
+                      std::memory_order order = std::memory_order_seq_cst)
+            -> value_type
+        {
+            Canonical out;
+            storage_.exchange(Canonical { val }.bytes, out.bytes, order);
+            return out.value();
+        }
+
+        auto compare_exchange_weak(
+            value_type& expected,
+            value_type const& desired,
+            std::memory_order order = std::memory_order_seq_cst) -> bool
+        {
+            return compare_exchange(expected, desired, true, order);
+        }
+
+        auto compare_exchange_strong(
+            value_type& expected,
+            value_type const& desired,
+            std::memory_order order = std::memory_order_seq_cst) -> bool
+        {
+            return compare_exchange(expected, desired, false, order);
+        }
+
+        auto operator=(value_type const& val) -> BasicAtomicVariant& {
+            store(val);
+            return *this;
+        }
+
+    private:
+        // The bytes of a value, canonicalised by `CanonicalCopy`.
+        struct Canonical {
+            Canonical() = default;
+
+            explicit Canonical(value_type const& val) {
+                dispatch<CanonicalCopy<value_type>, sizeof...(Ts)>(
+                    val.index(), val, static_cast<void*>(bytes));
+            }
+
+            auto value() const -> value_type {
+                return *reinterpret_cast<value_type const*>(bytes);
+            }
+
+            alignas(value_type) unsigned char bytes[sizeof(value_type)] = { };
+        };
+
+        auto compare_exchange(value_type& expected,
+                              value_type const& desired,
+                              bool weak,
+                              std::memory_order order) -> bool
+        {
+            Canonical current { expected };
+            auto const exchanged = storage_.compare_exchange(
+                current.bytes,
+                Canonical { desired }.bytes,
+                weak,
+                order,
+                failure_order(order));
+            if (!exchanged) {
+                expected = current.value();
+            }
+
+            return exchanged;
+        }
+
+        static constexpr auto failure_order(std::memory_order order)
+            -> std::memory_order
+        {
+            return order == std::memory_order_acq_rel
+                ? std::memory_order_acquire
+                : order == std::memory_order_release
+                    ? std::memory_order_relaxed
+                    : order;
+        }
+
+        AtomicStorage<sizeof(value_type), Strategy> storage_;
+    };
+
+    template<typename... Ts>
+    using AtomicVariant = BasicAtomicVariant<
+        default_atomic_strategy<sizeof(Variant<Ts...>)>(), Ts...>;
+}
+
+#endif //VARIANT_ATOMIC_HPP_INCLUDED
@@ -0,0 +1,338 @@
+#ifndef VARIANT_INSTRUMENTATION_HPP_INCLUDED
+#define VARIANT_INSTRUMENTATION_HPP_INCLUDED
+
+#include "variant/variant.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#define VARIANT_HAS_CXXABI
+#endif
+#endif
+
+namespace variant {
+
+    // Counts of what happened to one alternative of an instrumented
+    // variant type. See `VariantEvent` for what each one covers.
+    struct AlternativeStats {
+        std::string name;
+        std::uint64_t constructs = 0;
+        std::uint64_t copies = 0;
+        std::uint64_t moves = 0;
+        std::uint64_t destroys = 0;
+        std::uint64_t visits = 0;
+    };
+
+    // The counts for an instrumented variant type, summed over every
+    // thread that has used it, including those that have since exited.
+    struct VariantStats {
+        std::string name;
+        std::vector<AlternativeStats> alternatives;
+    };
+
+    // A readable name for `T`, or `fallback` where there's no RTTI.
+    template<typename T>
+    auto type_name(std::string fallback) -> std::string {
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
+        static_cast<void>(fallback);
+        auto const* mangled = typeid(T).name();
+#ifdef VARIANT_HAS_CXXABI
+        int status = 0;
+        std::unique_ptr<char, void (*)(void*)> demangled {
+            abi::__cxa_demangle(mangled, nullptr, nullptr, &status),
+            std::free
+        };
+        if (status == 0) {
+            return demangled.get();
+        }
+#endif
+        return mangled;
+#else
+        return fallback;
+#endif
+    }
+
+    constexpr size_t variant_event_count = 5;
+
+    // One thread's counters for one variant type, a row of
+    // `variant_event_count` per alternative. Only the thread using the
+    // block writes to it, so a count is bumped with a relaxed load and
+    // store rather than a locked increment; other threads may read a
+    // slightly stale count, but never a torn one.
+    struct CounterBlock {
+        explicit CounterBlock(size_t slots) :
+            counts(slots)
+        { }
+
+        auto bump(size_t slot) -> void {
+            auto& count = counts[slot];
+            count.store(count.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+        }
+
+        std::vector<std::atomic<std::uint64_t>> counts;
+    };
+
+    // The counter blocks for one variant type. Blocks are never freed:
+    // when a thread exits, its block is handed to the next thread to
+    // start, keeping its counts in the totals.
+    struct InstrumentedType {
+        InstrumentedType(std::string name,
+                         std::vector<std::string> alternatives)
+        :
+            name_ { std::move(name) },
+            alternatives_ { std::move(alternatives) }
+        { }
+
+        auto acquire() -> CounterBlock& {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            if (!free_.empty()) {
+                auto* block = free_.back();
+                free_.pop_back();
+                return *block;
+            }
+
+            blocks_.push_back(std::make_unique<CounterBlock>(
+                alternatives_.size() * variant_event_count));
+            return *blocks_.back();
+        }
+
+        auto release(CounterBlock& block) -> void {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            free_.push_back(&block);
+        }
+
+        auto stats() const -> VariantStats {
+            VariantStats result { name_, { } };
+            for (auto const& name : alternatives_) {
+                result.alternatives.push_back(AlternativeStats { name });
+            }
+
+            std::lock_guard<std::mutex> lock { mutex_ };
+            for (auto const& block : blocks_) {
+                for (size_t i = 0; i < alternatives_.size(); ++i) {
+                    auto const* row = &block->counts[i * variant_event_count];
+                    auto& alt = result.alternatives[i];
+                    alt.constructs += row[0].load(std::memory_order_relaxed);
+                    alt.copies += row[1].load(std::memory_order_relaxed);
+                    alt.moves += row[2].load(std::memory_order_relaxed);
+                    alt.destroys += row[3].load(std::memory_order_relaxed);
+                    alt.visits += row[4].load(std::memory_order_relaxed);
+                }
+            }
+
+            return result;
+        }
+
+    private:
+        std::string name_;
+        std::vector<std::string> alternatives_;
+        mutable std::mutex mutex_;
+        std::vector<std::unique_ptr<CounterBlock>> blocks_;
+        std::vector<CounterBlock*> free_;
+    };
+
+    // Every instrumented variant type, in the order each was first used.
+    // Never destroyed, so that variants with static or thread storage
+    // duration can still record as they're torn down.
+    struct InstrumentationRegistry {
+        static auto instance() -> InstrumentationRegistry& {
+            static auto* registry = new InstrumentationRegistry;
+            return *registry;
+        }
+
+        auto add(std::string name, std::vector<std::string> alternatives)
+            -> InstrumentedType&
+        {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            types_.push_back(std::make_unique<InstrumentedType>(
+                std::move(name), std::move(alternatives)));
+            return *types_.back();
+        }
+
+        auto snapshot() const -> std::vector<VariantStats> {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            std::vector<VariantStats> all;
+            all.reserve(types_.size());
+            for (auto const& type : types_) {
+                all.push_back(type->stats());
+            }
+
+            return all;
+        }
+
+    private:
+        InstrumentationRegistry() = default;
+
+        mutable std::mutex mutex_;
+        std::vector<std::unique_ptr<InstrumentedType>> types_;
+    };
+
+    template<typename V>
+    struct instrumented_type_of;
+
+    template<typename... Ts>
+    struct instrumented_type_of<Variant<Ts...>> {
+        static auto get() -> InstrumentedType& {
+            static auto& type = InstrumentationRegistry::instance().add(
+                type_name<Variant<Ts...>>("Variant"),
+                alternative_names(std::index_sequence_for<Ts...> { }));
+            return type;
+        }
+
+    private:
+        template<size_t... Is>
+        static auto alternative_names(std::index_sequence<Is...>)
+            -> std::vector<std::string>
+        {
+            return {
+                type_name<unboxed_t<Ts>>(
+                    "alternative " + std::to_string(Is))...
+            };
+        }
+    };
+
+    // Hands a block back when the thread that held it exits.
+    struct CounterBlockLease {
+        CounterBlockLease(InstrumentedType& type, CounterBlock& block) :
+            type_ { type },
+            block_ { block }
+        { }
+
+        CounterBlockLease(CounterBlockLease const&) = delete;
+        CounterBlockLease& operator=(CounterBlockLease const&) = delete;
+
+        ~CounterBlockLease() {
+            type_.release(block_);
+        }
+
+    private:
+        InstrumentedType& type_;
+        CounterBlock& block_;
+    };
+
+    // The calling thread's block for `V`. The pointer is trivially
+    // destructible, so it stays usable by anything torn down after the
+    // lease, such as variants with static storage duration.
+    template<typename V>
+    auto thread_counters() -> CounterBlock& {
+        thread_local CounterBlock* block = nullptr;
+        if (!block) {
+            auto& type = instrumented_type_of<V>::get();
+            block = &type.acquire();
+            thread_local CounterBlockLease lease { type, *block };
+        }
+
+        return *block;
+    }
+
+    // Counts every event per alternative in thread-local counters, which
+    // `instrumentation_stats` and `dump_instrumentation` add up on
+    // demand. Enable it for a variant with:
+    //
+    //     namespace variant {
+    //         template<>
+    //         struct variant_instrumentation<int, std::string> {
+    //             using type = CountingInstrumentation;
+    //         };
+    //     }
+    struct CountingInstrumentation {
+        static constexpr bool enabled = true;
+
+        template<typename V>
+        static auto record(VariantEvent event, size_t index) -> void {
+            thread_counters<V>().bump(
+                index * variant_event_count + static_cast<size_t>(event));
+        }
+    };
+
+    // The counts so far for the instrumented variant type `V`.
+    template<typename V>
+    auto instrumentation_stats() -> VariantStats {
+        return instrumented_type_of<V>::get().stats();
+    }
+
+    // The counts so far for every instrumented variant type that has been
+    // used.
+    inline auto instrumentation_snapshot() -> std::vector<VariantStats> {
+        return InstrumentationRegistry::instance().snapshot();
+    }
+
+    // The indices of the most visited alternatives in `stats`, busiest 
+    // first, up to those that between them account for `coverage` of 
+    // all the visits. These are the hints to give `variant_visit_hints` 
+    // or `visit_hinted`.
+    inline auto likely_alternatives(VariantStats const& stats, 
+                                    double coverage = 0.9) 
+        -> std::vector<size_t>
+    {
+        auto const& alts = stats.alternatives;
+        std::vector<size_t> order(alts.size());
+        std::iota(order.begin(), order.end(), size_t { 0 });
+        std::stable_sort(order.begin(), order.end(), 
+            [&](size_t lhs, size_t rhs) {
+                return alts[lhs].visits > alts[rhs].visits;
+            });
+
+        std::uint64_t total = 0;
+        for (auto const& alt : alts) {
+            total += alt.visits;
+        }
+
+        std::vector<size_t> likely;
+        std::uint64_t covered = 0;
+        for (auto i : order) {
+            if (covered >= coverage * static_cast<double>(total)) {
+                break;
+            }
+            likely.push_back(i);
+            covered += alts[i].visits;
+        }
+
+        return likely;
+    }
+
+    inline auto write_csv_field(std::ostream& out, std::string const& field)
+        -> void
+    {
+        out << '"';
+        for (auto c : field) {
+            if (c == '"') {
+                out << '"';
+            }
+            out << c;
+        }
+        out << '"';
+    }
+
+    // Writes `instrumentation_snapshot()` as CSV, with a header row and
+    // then one row per alternative of each type.
+    inline auto dump_instrumentation(std::ostream& out) -> void {
+        out << "variant,alternative,constructs,copies,moves,destroys,visits\n";
+        for (auto const& type : instrumentation_snapshot()) {
+            for (auto const& alt : type.alternatives) {
+                write_csv_field(out, type.name);
+                out << ',';
+                write_csv_field(out, alt.name);
+                out << ',' << alt.constructs
+                    << ',' << alt.copies
+                    << ',' << alt.moves
+                    << ',' << alt.destroys
+                    << ',' << alt.visits << '\n';
+            }
+        }
+    }
+}
+
+#endif //VARIANT_INSTRUMENTATION_HPP_INCLUDED
@@ -0,0 +1,356 @@
+#ifndef VARIANT_PARALLEL_HPP_INCLUDED
+#define VARIANT_PARALLEL_HPP_INCLUDED
+
+#include "variant/variant.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace variant {
+
+    // A fixed-size pool of worker threads, each with its own task queue. 
+    // Idle workers steal from the front of other workers' queues, so an 
+    // uneven split of work still keeps every thread busy.
+    //
+    // Any type with `concurrency()` and `submit(std::function<void()>)` 
+    // can stand in for it as the executor of `parallel_visit_each`. One 
+    // that also has `run_pending() -> bool` lets the waiting thread run 
+    // queued tasks, which is what makes nested calls safe.
+    struct ThreadPool {
+        using Task = std::function<void()>;
+
+        // Asking for no threads still gets one.
+        explicit ThreadPool(
+            size_t threads = std::max(std::thread::hardware_concurrency(), 1u))
+        {
+            threads = std::max(threads, size_t { 1 });
+            queues_.reserve(threads);
+            for (size_t i = 0; i < threads; ++i) {
+                queues_.push_back(std::make_unique<Queue>());
+            }
+
+            threads_.reserve(threads);
+            for (size_t i = 0; i < threads; ++i) {
+                threads_.emplace_back([this, i] { work(i); });
+            }
+        }
+
+        ThreadPool(ThreadPool const&) = delete;
+        ThreadPool& operator=(ThreadPool const&) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock { sleep_mutex_ };
+                stopping_ = true;
+            }
+            wake_.notify_all();
+
+            for (auto& t : threads_) {
+                t.join();
+            }
+        }
+
+        auto concurrency() const -> size_t {
+            return threads_.size();
+        }
+
+        // Counts the task as pending before queueing it, so a worker that
+        // takes it straight away can never bring the count below zero.
+        auto submit(Task task) -> void {
+            {
+                std::lock_guard<std::mutex> lock { sleep_mutex_ };
+                ++pending_;
+            }
+
+            auto& queue = *queues_[next_queue_++ % queues_.size()];
+            {
+                std::lock_guard<std::mutex> lock { queue.mutex };
+                queue.tasks.push_back(std::move(task));
+            }
+            wake_.notify_one();
+        }
+
+        // Runs one queued task on the calling thread, if there is one.
+        auto run_pending() -> bool {
+            Task task;
+            if (!try_take_front(0, queues_.size(), task)) {
+                return false;
+            }
+
+            --pending_;
+            task();
+            return true;
+        }
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        auto work(size_t index) -> void {
+            Task task;
+            for (;;) {
+                if (try_pop(index, task) || try_steal(index, task)) {
+                    --pending_;
+                    task();
+                    task = nullptr;
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock { sleep_mutex_ };
+                wake_.wait(lock, [this] { return stopping_ || pending_ > 0; });
+                if (stopping_ && pending_ == 0) {
+                    return;
+                }
+            }
+        }
+
+        auto try_pop(size_t index, Task& task) -> bool {
+            auto& queue = *queues_[index];
+            std::lock_guard<std::mutex> lock { queue.mutex };
+            if (queue.tasks.empty()) {
+                return false;
+            }
+
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+
+        auto try_steal(size_t index, Task& task) -> bool {
+            return try_take_front(index + 1, queues_.size() - 1, task);
+        }
+
+        // Takes the oldest task from the first non-empty queue of `count`,
+        // starting at `first` and wrapping round.
+        auto try_take_front(size_t first, size_t count, Task& task) -> bool {
+            for (size_t i = 0; i < count; ++i) {
+                auto& queue = *queues_[(first + i) % queues_.size()];
+                std::lock_guard<std::mutex> lock { queue.mutex };
+                if (!queue.tasks.empty()) {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> threads_;
+        std::atomic<size_t> next_queue_ { 0 };
+        std::atomic<size_t> pending_ { 0 };
+        std::mutex sleep_mutex_;
+        std::condition_variable wake_;
+        bool stopping_ = false;
+    };
+
+    // Blocks until `count` chunks have finished, and holds the first 
+    // exception any of them threw.
+    struct ChunkLatch {
+        explicit ChunkLatch(size_t count) :
+            remaining_ { count }
+        { }
+
+        auto count_down() -> void {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            if (--remaining_ == 0) {
+                done_.notify_all();
+            }
+        }
+
+#ifndef VARIANT_NO_EXCEPTIONS
+        auto fail(std::exception_ptr e) -> void {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            if (!error_) {
+                error_ = e;
+            }
+        }
+#endif
+
+        // Waits up to `timeout` for every chunk to finish, and says 
+        // whether they have.
+        auto wait_for(std::chrono::microseconds timeout) -> bool {
+            std::unique_lock<std::mutex> lock { mutex_ };
+            return done_.wait_for(
+                lock, timeout, [this] { return remaining_ == 0; });
+        }
+
+        auto wait() -> void {
+            std::unique_lock<std::mutex> lock { mutex_ };
+            done_.wait(lock, [this] { return remaining_ == 0; });
+#ifndef VARIANT_NO_EXCEPTIONS
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+#endif
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable done_;
+        size_t remaining_;
+#ifndef VARIANT_NO_EXCEPTIONS
+        std::exception_ptr error_;
+#endif
+    };
+
+    // How [0, size) is split up: a few chunks per executor thread, so 
+    // that stealing can even out uneven work, but never so small that 
+    // scheduling dominates.
+    struct ChunkLayout {
+        size_t chunk;
+        size_t count;
+    };
+
+    template<typename Executor>
+    auto chunk_layout(size_t size, Executor const& executor) -> ChunkLayout {
+        constexpr size_t chunks_per_thread = 4;
+        constexpr size_t min_chunk = 1024;
+
+        auto const chunk = std::max(
+            min_chunk, 
+            size / (executor.concurrency() * chunks_per_thread) + 1);
+        return { chunk, (size + chunk - 1) / chunk };
+    }
+
+    // Runs `executor`'s queued tasks while the chunks finish, so that a 
+    // worker waiting on a nested call still makes progress rather than 
+    // blocking while its chunks sit in the queues.
+    template<typename Executor>
+    auto wait_for_chunks(ChunkLatch& latch, Executor& executor, int)
+        -> decltype(executor.run_pending(), void())
+    {
+        while (!latch.wait_for(std::chrono::microseconds { 0 })) {
+            if (!executor.run_pending()) {
+                latch.wait_for(std::chrono::microseconds { 100 });
+            }
+        }
+
+        latch.wait();
+    }
+
+    // An executor that can't run tasks on the waiting thread mustn't be 
+    // used from inside one of its own tasks.
+    template<typename Executor>
+    auto wait_for_chunks(ChunkLatch& latch, Executor&, long) -> void {
+        latch.wait();
+    }
+
+    // Runs `f(chunk, first, last)` for each chunk of `layout` through 
+    // `executor`, and returns once every chunk has finished.
+    template<typename F, typename Executor>
+    auto parallel_chunks(size_t size, 
+                         ChunkLayout layout,
+                         Executor& executor, 
+                         F const& f) 
+        -> void 
+    {
+        ChunkLatch latch { layout.count };
+        for (size_t i = 0; i < layout.count; ++i) {
+            auto const first = i * layout.chunk;
+            auto const last = std::min(size, first + layout.chunk);
+            executor.submit(
+                [&latch, &f, i, first, last] {
+#ifndef VARIANT_NO_EXCEPTIONS
+                    try {
+                        f(i, first, last);
+                    }
+                    catch (...) {
+                        latch.fail(std::current_exception());
+                    }
+#else
+                    f(i, first, last);
+#endif
+                    latch.count_down();
+                });
+        }
+
+        wait_for_chunks(latch, executor, 0);
+    }
+
+    // Visits every element of a random access range of `Variant`s across
+    // the threads of `executor`. Each chunk gets its own copy of 
+    // `visitor`, so a stateful visitor is never shared between threads.
+    template<typename Range, typename F, typename Executor>
+    auto parallel_visit_each(Range&& range, 
+                             F const& visitor, 
+                             Executor& executor) 
+        -> void 
+    {
+        auto first = std::begin(range);
+        auto const size = static_cast<size_t>(
+            std::distance(first, std::end(range)));
+
+        parallel_chunks(
+            size, 
+            chunk_layout(size, executor),
+            executor, 
+            [first, &visitor](size_t, size_t begin, size_t end) {
+                auto local = visitor;
+                for (auto it = first + begin; it != first + end; ++it) {
+                    (*it).visit(local);
+                }
+            });
+    }
+
+    // As `parallel_visit_each`, but `combine`s the visitor's results. Each
+    // chunk folds its own results, then the per-chunk results are folded 
+    // into `init` in range order, so the outcome doesn't depend on 
+    // scheduling even if `combine` isn't commutative.
+    template<typename Range, 
+             typename F, 
+             typename T, 
+             typename Combine, 
+             typename Executor>
+    auto parallel_visit_reduce(Range&& range, 
+                               F const& visitor, 
+                               T init,
+                               Combine const& combine,
+                               Executor& executor) 
+        -> T 
+    {
+        auto first = std::begin(range);
+        auto const size = static_cast<size_t>(
+            std::distance(first, std::end(range)));
+
+        // Chunks write to distinct slots, so no locking is needed.
+        auto const layout = chunk_layout(size, executor);
+        std::vector<std::unique_ptr<T>> partials(layout.count);
+
+        parallel_chunks(
+            size, 
+            layout,
+            executor, 
+            [&partials, &visitor, &combine, first](
+                size_t chunk, size_t begin, size_t end) 
+            {
+                auto local = visitor;
+                auto it = first + begin;
+                T partial = (*it).visit(local);
+                while (++it != first + end) {
+                    partial = combine(std::move(partial), (*it).visit(local));
+                }
+
+                partials[chunk] = std::make_unique<T>(std::move(partial));
+            });
+
+        for (auto& p : partials) {
+            init = combine(std::move(init), std::move(*p));
+        }
+
+        return init;
+    }
+}
+#endif //VARIANT_PARALLEL_HPP_INCLUDED
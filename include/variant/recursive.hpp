@@ -0,0 +1,401 @@
+#ifndef VARIANT_RECURSIVE_HPP_INCLUDED
+#define VARIANT_RECURSIVE_HPP_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace variant {
+
+    // Hands out memory from large blocks, bumping a pointer through each.
+    // Nothing is freed until the arena is released or destroyed, so
+    // everything allocated from it must be destroyed first.
+    struct MonotonicArena {
+        explicit MonotonicArena(size_t initial_block = 4096) :
+            next_block_ { std::max(initial_block, sizeof(Block)) }
+        { }
+
+        MonotonicArena(MonotonicArena const&) = delete;
+        MonotonicArena& operator=(MonotonicArena const&) = delete;
+
+        ~MonotonicArena() {
+            release();
+        }
+
+        auto allocate(size_t bytes, size_t alignment) -> void* {
+            auto p = align_up(cursor_, alignment);
+            if (!cursor_ || p + bytes > end_) {
+                add_block(bytes + alignment);
+                p = align_up(cursor_, alignment);
+            }
+
+            cursor_ = p + bytes;
+            return reinterpret_cast<void*>(p);
+        }
+
+        // Frees every block. Anything still allocated from the arena is
+        // left dangling.
+        auto release() -> void {
+            while (head_) {
+                auto* next = head_->next;
+                ::operator delete(static_cast<void*>(head_));
+                head_ = next;
+            }
+
+            cursor_ = 0;
+            end_ = 0;
+        }
+
+        auto block_count() const -> size_t {
+            size_t count = 0;
+            for (auto* b = head_; b; b = b->next) {
+                ++count;
+            }
+
+            return count;
+        }
+
+    private:
+        struct Block {
+            Block* next;
+        };
+
+        static auto align_up(std::uintptr_t p, size_t alignment)
+            -> std::uintptr_t
+        {
+            auto const mask = static_cast<std::uintptr_t>(alignment) - 1;
+            return (p + mask) & ~mask;
+        }
+
+        // Blocks double in size, so a large tree needs only a handful of
+        // calls into the global allocator.
+        auto add_block(size_t at_least) -> void {
+            auto const size = std::max(next_block_, at_least + sizeof(Block));
+            auto* block = static_cast<Block*>(::operator new(size));
+            block->next = head_;
+            head_ = block;
+
+            cursor_ = reinterpret_cast<std::uintptr_t>(block + 1);
+            end_ = reinterpret_cast<std::uintptr_t>(block) + size;
+            next_block_ = size * 2;
+        }
+
+        Block* head_ = nullptr;
+        std::uintptr_t cursor_ = 0;
+        std::uintptr_t end_ = 0;
+        size_t next_block_;
+    };
+
+    // The arena default constructed `ArenaAllocator`s on this thread draw
+    // from, or null for the global heap.
+    inline auto current_arena() -> MonotonicArena*& {
+        static thread_local MonotonicArena* arena = nullptr;
+        return arena;
+    }
+
+    // Makes `arena` the current arena for as long as the scope lives, so
+    // that containers built inside it allocate from the arena without each
+    // being handed an allocator.
+    struct ArenaScope {
+        explicit ArenaScope(MonotonicArena& arena) :
+            previous_ { current_arena() }
+        {
+            current_arena() = &arena;
+        }
+
+        ArenaScope(ArenaScope const&) = delete;
+        ArenaScope& operator=(ArenaScope const&) = delete;
+
+        ~ArenaScope() {
+            current_arena() = previous_;
+        }
+
+    private:
+        MonotonicArena* previous_;
+    };
+
+    // An allocator that draws from a `MonotonicArena`, or from the global
+    // heap when it has none. Copies share the arena, so a copied tree
+    // lands in the same arena as the original.
+    template<typename T>
+    struct ArenaAllocator {
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        ArenaAllocator() noexcept :
+            arena_ { current_arena() }
+        { }
+
+        explicit ArenaAllocator(MonotonicArena& arena) noexcept :
+            arena_ { &arena }
+        { }
+
+        template<typename U>
+        ArenaAllocator(ArenaAllocator<U> const& other) noexcept :
+            arena_ { other.arena() }
+        { }
+
+        auto allocate(size_t n) -> T* {
+            if (!arena_) {
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+            }
+
+            return static_cast<T*>(
+                arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        auto deallocate(T* p, size_t) noexcept -> void {
+            if (!arena_) {
+                ::operator delete(static_cast<void*>(p));
+            }
+        }
+
+        auto arena() const noexcept -> MonotonicArena* {
+            return arena_;
+        }
+
+    private:
+        MonotonicArena* arena_;
+    };
+
+    template<typename T, typename U>
+    auto operator==(ArenaAllocator<T> const& lhs, ArenaAllocator<U> const& rhs)
+        noexcept -> bool
+    {
+        return lhs.arena() == rhs.arena();
+    }
+
+    template<typename T, typename U>
+    auto operator!=(ArenaAllocator<T> const& lhs, ArenaAllocator<U> const& rhs)
+        noexcept -> bool
+    {
+        return !(lhs == rhs);
+    }
+
+    // Holds a `T` out of line so that a variant can contain itself,
+    // e.g. an array of values that are themselves variants. Copying copies
+    // the `T`; moving only moves the pointer, leaving the source empty.
+    //
+    // The `T` is allocated with `Alloc`, which is stored alongside the
+    // pointer but takes no space when it is stateless. A `T` that uses 
+    // allocators, such as a container, is also constructed with it, so 
+    // its own elements come from the same place; any other `T` copies its
+    // members by their own rules.
+    template<typename T, typename Alloc = std::allocator<T>>
+    struct recursive {
+        using allocator_type = Alloc;
+
+        recursive(T const& val) :
+            recursive { std::allocator_arg, Alloc { }, val }
+        { }
+
+        recursive(T&& val) :
+            recursive { std::allocator_arg, Alloc { }, std::move(val) }
+        { }
+
+        template<typename... Args>
+        recursive(std::allocator_arg_t, Alloc const& alloc, Args&&... args) :
+            holder_ { alloc, nullptr }
+        {
+            holder_.ptr = create(std::forward<Args>(args)...);
+        }
+
+        recursive(recursive const& other) :
+            holder_ {
+                Traits::select_on_container_copy_construction(
+                    other.holder_.allocator()),
+                nullptr
+            }
+        {
+            holder_.ptr = create(*other);
+        }
+
+        recursive(recursive&& other) noexcept :
+            holder_ { std::move(other.holder_.allocator()), other.holder_.ptr }
+        {
+            other.holder_.ptr = nullptr;
+        }
+
+        // Keeps this allocator, and copies the value into it.
+        recursive& operator=(recursive const& other) {
+            recursive tmp { std::allocator_arg, holder_.allocator(), *other };
+            swap(tmp);
+            return *this;
+        }
+
+        // The allocator moves with the pointer, so the value is always
+        // freed by the allocator it came from.
+        recursive& operator=(recursive&& other) noexcept {
+            recursive tmp { std::move(other) };
+            swap(tmp);
+            return *this;
+        }
+
+        ~recursive() {
+            if (holder_.ptr) {
+                Traits::destroy(holder_.allocator(), holder_.ptr);
+                Traits::deallocate(holder_.allocator(), holder_.ptr, 1);
+            }
+        }
+
+        auto swap(recursive& other) noexcept -> void {
+            using std::swap;
+            swap(holder_.allocator(), other.holder_.allocator());
+            swap(holder_.ptr, other.holder_.ptr);
+        }
+
+        auto get_allocator() const -> Alloc {
+            return holder_.allocator();
+        }
+
+        // A `recursive` that has been moved from holds nothing until it's
+        // assigned to.
+        operator T&() {
+            assert(holder_.ptr && "recursive used after being moved from");
+            return *holder_.ptr;
+        }
+
+        operator T const&() const {
+            assert(holder_.ptr && "recursive used after being moved from");
+            return *holder_.ptr;
+        }
+
+        T* operator->() {
+            assert(holder_.ptr && "recursive used after being moved from");
+            return holder_.ptr;
+        }
+
+        T const* operator->() const {
+            assert(holder_.ptr && "recursive used after being moved from");
+            return holder_.ptr;
+        }
+
+        T& operator*() {
+            assert(holder_.ptr && "recursive used after being moved from");
+            return *holder_.ptr;
+        }
+
+        T const& operator*() const {
+            assert(holder_.ptr && "recursive used after being moved from");
+            return *holder_.ptr;
+        }
+
+    private:
+        using Traits = std::allocator_traits<Alloc>;
+
+        template<typename... Args>
+        auto create(Args&&... args) -> T* {
+            auto& alloc = holder_.allocator();
+            auto* p = Traits::allocate(alloc, 1);
+#ifndef VARIANT_NO_EXCEPTIONS
+            try {
+                construct_at(p, std::forward<Args>(args)...);
+            }
+            catch (...) {
+                Traits::deallocate(alloc, p, 1);
+                throw;
+            }
+#else
+            construct_at(p, std::forward<Args>(args)...);
+#endif
+            return p;
+        }
+
+        template<typename... Args>
+        using takes_leading_allocator = std::integral_constant<
+            bool,
+            std::uses_allocator<T, Alloc>::value &&
+                std::is_constructible<
+                    T, std::allocator_arg_t, Alloc const&, Args...>::value>;
+
+        template<typename... Args>
+        using takes_trailing_allocator = std::integral_constant<
+            bool,
+            std::uses_allocator<T, Alloc>::value &&
+                std::is_constructible<T, Args..., Alloc const&>::value>;
+
+        // Uses-allocator construction: hands `T` the allocator, leading 
+        // or trailing, when it takes one.
+        template<typename... Args>
+        auto construct_at(T* p, Args&&... args) -> void {
+            construct_with(
+                p,
+                takes_leading_allocator<Args...> { },
+                takes_trailing_allocator<Args...> { },
+                std::forward<Args>(args)...);
+        }
+
+        template<typename Trailing, typename... Args>
+        auto construct_with(T* p, std::true_type, Trailing, Args&&... args)
+            -> void
+        {
+            auto& alloc = holder_.allocator();
+            Traits::construct(alloc, p, std::allocator_arg, alloc,
+                              std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        auto construct_with(T* p, 
+                            std::false_type, 
+                            std::true_type, 
+                            Args&&... args)
+            -> void
+        {
+            auto& alloc = holder_.allocator();
+            Traits::construct(alloc, p, std::forward<Args>(args)...,
+                              static_cast<Alloc const&>(alloc));
+        }
+
+        template<typename... Args>
+        auto construct_with(T* p, 
+                            std::false_type, 
+                            std::false_type, 
+                            Args&&... args)
+            -> void
+        {
+            Traits::construct(holder_.allocator(), p, 
+                              std::forward<Args>(args)...);
+        }
+
+        // Derives from the allocator so that a stateless one adds nothing
+        // to the size of `recursive`.
+        struct Holder : Alloc {
+            Holder(Alloc const& alloc, T* p) :
+                Alloc { alloc },
+                ptr { p }
+            { }
+
+            Holder(Alloc&& alloc, T* p) :
+                Alloc { std::move(alloc) },
+                ptr { p }
+            { }
+
+            auto allocator() -> Alloc& {
+                return *this;
+            }
+
+            auto allocator() const -> Alloc const& {
+                return *this;
+            }
+
+            T* ptr;
+        };
+
+        Holder holder_;
+    };
+
+    template<typename T, typename Alloc>
+    auto swap(recursive<T, Alloc>& lhs, recursive<T, Alloc>& rhs) noexcept
+        -> void
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif //VARIANT_RECURSIVE_HPP_INCLUDED
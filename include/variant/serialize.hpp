@@ -0,0 +1,355 @@
+#ifndef VARIANT_SERIALIZE_HPP_INCLUDED
+#define VARIANT_SERIALIZE_HPP_INCLUDED
+
+#include "variant/variant.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace variant {
+
+    // A variant is written as its index, in the variant's own index type,
+    // followed by the active alternative. Values are written in the host's
+    // byte order and layout, so the format is for shipping between
+    // processes built for the same platform, not for long-term storage.
+    //
+    // Every value starts at a multiple of its alignment, measured from the
+    // start of the output, so that a reader over a suitably aligned buffer
+    // can hand out references straight into it.
+
+    struct DeserializationError : std::runtime_error {
+        explicit DeserializationError(char const* what) :
+            std::runtime_error(what)
+        { }
+    };
+
+    [[noreturn]] inline auto corrupt_input(char const* what) -> void {
+#ifdef VARIANT_NO_EXCEPTIONS
+        (void)what;
+        assert(!"Attempted to deserialize corrupt input");
+        std::abort();
+#else
+        throw DeserializationError { what };
+#endif
+    }
+
+    // Whether a `T` is written as its raw bytes. Specialise this as
+    // `std::false_type` for trivially copyable types whose bytes don't
+    // survive the trip, such as handles.
+    template<typename T>
+    struct is_trivially_serializable
+        : std::integral_constant<
+            bool,
+            std::is_trivially_copyable<T>::value &&
+                !std::is_pointer<T>::value &&
+                !std::is_member_pointer<T>::value>
+    { };
+
+    // Accumulates serialized values in a buffer of its own, which grows
+    // geometrically rather than one value at a time.
+    struct BinaryWriter {
+        // Appends `size` bytes from `data`, after zeroed padding up to a
+        // multiple of `align`.
+        auto write_bytes(void const* data, size_t size, size_t align = 1)
+            -> void
+        {
+            auto const start = size_ + (align - size_ % align) % align;
+            if (start + size > buffer_.size()) {
+                grow(start + size);
+            }
+
+            std::memset(buffer_.data() + size_, 0, start - size_);
+            std::memcpy(buffer_.data() + start, data, size);
+            size_ = start + size;
+        }
+
+        // Replaces `size` bytes already written at `offset`, such as a
+        // length that wasn't known until after what it measures.
+        auto overwrite(size_t offset, void const* data, size_t size) 
+            -> void 
+        {
+            assert(offset <= size_ && size <= size_ - offset);
+            std::memcpy(buffer_.data() + offset, data, size);
+        }
+
+        template<typename T>
+        auto write(T const& val) -> void;
+
+        auto data() const -> unsigned char const* {
+            return buffer_.data();
+        }
+
+        auto size() const -> size_t {
+            return size_;
+        }
+
+        // Empties the writer, keeping its buffer for reuse.
+        auto clear() -> void {
+            size_ = 0;
+        }
+
+        // Hands over everything written so far, leaving the writer empty.
+        auto release() -> std::vector<unsigned char> {
+            buffer_.resize(size_);
+            size_ = 0;
+            return std::move(buffer_);
+        }
+
+    private:
+        auto grow(size_t required) -> void {
+            buffer_.resize(std::max(required, buffer_.size() * 2));
+        }
+
+        std::vector<unsigned char> buffer_;
+        size_t size_ = 0;
+    };
+
+    // Reads serialized values back out of bytes written by a 
+    // `BinaryWriter`, starting from the same place the writer did.
+    struct BinaryReader {
+        BinaryReader(void const* data, size_t size) :
+            data_ { static_cast<unsigned char const*>(data) },
+            size_ { size },
+            position_ { 0 }
+        { }
+
+        explicit BinaryReader(std::vector<unsigned char> const& in) :
+            BinaryReader { in.data(), in.size() }
+        { }
+
+        explicit BinaryReader(BinaryWriter const& in) :
+            BinaryReader { in.data(), in.size() }
+        { }
+
+        // The next `size` bytes, after skipping padding up to a multiple
+        // of `align`. The bytes stay owned by the source buffer.
+        auto read_bytes(size_t size, size_t align = 1)
+            -> unsigned char const*
+        {
+            auto const start =
+                position_ + (align - position_ % align) % align;
+            if (start > size_ || size > size_ - start) {
+                corrupt_input("Serialized input is truncated");
+            }
+
+            position_ = start + size;
+            return data_ + start;
+        }
+
+        template<typename T>
+        auto read() -> T;
+
+        auto position() const -> size_t {
+            return position_;
+        }
+
+        auto empty() const -> bool {
+            return position_ == size_;
+        }
+
+    private:
+        unsigned char const* data_;
+        size_t size_;
+        size_t position_;
+    };
+
+    // The customisation point for how a `T` is written and read. The
+    // primary template copies the bytes of trivially serializable types;
+    // specialise it for anything else, giving it a static
+    // `write(BinaryWriter&, T const&)` and a static
+    // `read(BinaryReader&) -> T`.
+    template<typename T>
+    struct serializer {
+        static_assert(is_trivially_serializable<T>::value,
+            "Specialise variant::serializer<T> for alternatives that can't "
+            "be written as their bytes");
+
+        static auto write(BinaryWriter& w, T const& val) -> void {
+            w.write_bytes(&val, sizeof(T), alignof(T));
+        }
+
+        // Copies out through suitably aligned storage, so `T` needn't be
+        // default constructible.
+        static auto read(BinaryReader& r) -> T {
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type
+                storage;
+            std::memcpy(&storage, r.read_bytes(sizeof(T), alignof(T)),
+                        sizeof(T));
+            return *reinterpret_cast<T const*>(&storage);
+        }
+    };
+
+    template<typename T>
+    auto BinaryWriter::write(T const& val) -> void {
+        serializer<T>::write(*this, val);
+    }
+
+    template<typename T>
+    auto BinaryReader::read() -> T {
+        return serializer<T>::read(*this);
+    }
+
+    template<typename CharT, typename Traits, typename Alloc>
+    struct serializer<std::basic_string<CharT, Traits, Alloc>> {
+        using String = std::basic_string<CharT, Traits, Alloc>;
+
+        static auto write(BinaryWriter& w, String const& val) -> void {
+            w.write(static_cast<std::uint64_t>(val.size()));
+            w.write_bytes(val.data(), val.size() * sizeof(CharT),
+                          alignof(CharT));
+        }
+
+        static auto read(BinaryReader& r) -> String {
+            auto const size = r.read<std::uint64_t>();
+            if (size > std::numeric_limits<size_t>::max() / sizeof(CharT)) {
+                corrupt_input("Serialized string is too long");
+            }
+
+            auto const* chars = r.read_bytes(
+                static_cast<size_t>(size) * sizeof(CharT), alignof(CharT));
+            String val(static_cast<size_t>(size), CharT { });
+            std::memcpy(&val[0], chars, val.size() * sizeof(CharT));
+            return val;
+        }
+    };
+
+    // Writes alternative `K` of a variant.
+    template<typename V>
+    struct WriteAlternative {
+        using Fn = auto (*)(BinaryWriter&, V const&) -> void;
+
+        template<size_t K>
+        static auto call(BinaryWriter& w, V const& v) -> void {
+            w.write(v.template unsafe_get<K>());
+        }
+    };
+
+    // Reads alternative `K` of a `Variant<Ts...>`.
+    template<typename... Ts>
+    struct ReadAlternative {
+        using Fn = auto (*)(BinaryReader&) -> Variant<Ts...>;
+
+        template<size_t K>
+        static auto call(BinaryReader& r) -> Variant<Ts...> {
+            return Variant<Ts...> {
+                in_place_index<K>,
+                r.read<alternative_t<K, Ts...>>()
+            };
+        }
+    };
+
+    template<typename T, typename F>
+    decltype(auto) visit_in_place(BinaryReader& r, F&& f, std::true_type) {
+        auto const* bytes = r.read_bytes(sizeof(T), alignof(T));
+        if (reinterpret_cast<std::uintptr_t>(bytes) % alignof(T) == 0) {
+            return std::forward<F>(f)(*reinterpret_cast<T const*>(bytes));
+        }
+
+        // The buffer itself is misaligned, so the value has to be copied
+        // out before it can be referred to.
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        std::memcpy(&storage, bytes, sizeof(T));
+        return std::forward<F>(f)(*reinterpret_cast<T const*>(&storage));
+    }
+
+    template<typename T, typename F>
+    decltype(auto) visit_in_place(BinaryReader& r, F&& f, std::false_type) {
+        T const val = r.read<T>();
+        return std::forward<F>(f)(val);
+    }
+
+    // Calls a visitor on alternative `K` where it lies in the input.
+    template<typename R, typename F, typename... Ts>
+    struct VisitSerialized {
+        using Fn = auto (*)(BinaryReader&, F&&) -> R;
+
+        template<size_t K>
+        static auto call(BinaryReader& r, F&& f) -> R {
+            using T = alternative_t<K, Ts...>;
+            return visit_in_place<T>(
+                r,
+                std::forward<F>(f),
+                is_trivially_serializable<T> { });
+        }
+    };
+
+    template<typename... Ts>
+    struct serializer<Variant<Ts...>> {
+        using Index = index_type_t<sizeof...(Ts)>;
+
+        static auto write(BinaryWriter& w, Variant<Ts...> const& v) -> void {
+            w.write(static_cast<Index>(v.index()));
+            dispatch<WriteAlternative<Variant<Ts...>>, sizeof...(Ts)>(
+                v.index(), w, v);
+        }
+
+        static auto read(BinaryReader& r) -> Variant<Ts...> {
+            return dispatch<ReadAlternative<Ts...>, sizeof...(Ts)>(
+                read_index(r), r);
+        }
+
+        static auto read_index(BinaryReader& r) -> size_t {
+            size_t const index = r.read<Index>();
+            if (index >= sizeof...(Ts)) {
+                corrupt_input("Serialized variant has an invalid index");
+            }
+
+            return index;
+        }
+    };
+
+    // Appends `v` to the output of `w`.
+    template<typename... Ts>
+    auto serialize(BinaryWriter& w, Variant<Ts...> const& v) -> void {
+        w.write(v);
+    }
+
+    template<typename... Ts>
+    auto serialize(Variant<Ts...> const& v) -> std::vector<unsigned char> {
+        BinaryWriter w;
+        w.write(v);
+        return w.release();
+    }
+
+    // Reads the next `V` from `r`, copying its payload out of the input.
+    template<typename V>
+    auto deserialize(BinaryReader& r) -> V {
+        return r.read<V>();
+    }
+
+    template<typename V>
+    struct SerializedVisitor;
+
+    template<typename... Ts>
+    struct SerializedVisitor<Variant<Ts...>> {
+        template<typename F>
+        static decltype(auto) visit(BinaryReader& r, F&& f) {
+            using R = decltype(std::forward<F>(f)(
+                std::declval<alternative_t<0, Ts...> const&>()));
+
+            return dispatch<VisitSerialized<R, F, Ts...>, sizeof...(Ts)>(
+                serializer<Variant<Ts...>>::read_index(r),
+                r,
+                std::forward<F>(f));
+        }
+    };
+
+    // Reads the next `V` from `r` and calls `visitor` with its active
+    // alternative, without building a `V`. Trivially serializable
+    // alternatives are passed as references straight into the input,
+    // which must outlive the call; anything else is read into a
+    // temporary first.
+    template<typename V, typename F>
+    decltype(auto) visit_serialized(BinaryReader& r, F&& visitor) {
+        return SerializedVisitor<V>::visit(r, std::forward<F>(visitor));
+    }
+}
+
+#endif //VARIANT_SERIALIZE_HPP_INCLUDED
@@ -3,9 +3,33 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
 #include <type_traits>
 #include <stdexcept>
-#include <tuple>
+#include <utility>
+
+// Define VARIANT_NO_EXCEPTIONS to have accessing the wrong alternative 
+// assert and abort instead of throwing `IncorrectAlternativeError`. It is 
+// defined automatically when the compiler has exceptions disabled.
+#if !defined(VARIANT_NO_EXCEPTIONS) && \
+    !(defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND))
+#define VARIANT_NO_EXCEPTIONS
+#endif
+
+#ifdef VARIANT_NO_EXCEPTIONS
+#include <cstdlib>
+#endif
+
+// Marks the branches of a hinted visit as the ones to lay out first.
+#if defined(__GNUC__) || defined(__clang__)
+#define VARIANT_LIKELY(cond) __builtin_expect(!!(cond), 1)
+#else
+#define VARIANT_LIKELY(cond) (cond)
+#endif
 
 namespace variant {
 
@@ -19,105 +43,386 @@ namespace variant {
         return std::max({ alignof(Ts)... });
     }
 
-    template<size_t N, typename U, typename... Ts>
-    struct type_index_of;
+    template<bool... Bs>
+    struct bool_list { };
+
+    // Whether every one of `Bs` holds, without instantiating a template 
+    // per element.
+    template<bool... Bs>
+    struct all_true 
+        : std::is_same<bool_list<true, Bs...>, bool_list<Bs..., true>> 
+    { };
+
+    // The position of the first `true` in `Bs`, or `sizeof...(Bs)`.
+    template<bool... Bs>
+    constexpr auto first_true() -> size_t {
+        bool const values[] = { Bs..., true };
+        size_t i = 0;
+        while (!values[i]) {
+            ++i;
+        }
+
+        return i;
+    }
 
-    template<size_t N, typename U, typename V, typename... Ts>
-    struct type_index_of<N, U, V, Ts...> {
-        static constexpr size_t value = 
-            type_index_of<N+1, U, Ts...>::value;
+    template<size_t N, size_t I, size_t Count>
+    struct found_index {
+        static constexpr size_t value = N + I;
     };
 
+    template<size_t N, size_t Count>
+    struct found_index<N, Count, Count> { };
+
+    // The index, offset by `N`, of the first `U` in `Ts`. There is no 
+    // `value` when `U` isn't one of `Ts`.
     template<size_t N, typename U, typename... Ts>
-    struct type_index_of<N, U, U, Ts...> {
-        static constexpr size_t value = N;
-    };
+    struct type_index_of 
+        : found_index<
+            N, 
+            first_true<std::is_same<U, Ts>::value...>(), 
+            sizeof...(Ts)>
+    { };
 
-    template<size_t N, typename U>
-    struct type_index_of<N, U> { };
+    template<typename... Ts>
+    struct all_move_constructible 
+        : all_true<std::is_move_constructible<Ts>::value...>
+    { };
 
     template<typename... Ts>
-    struct all_move_constructible;
+    struct all_copy_constructible 
+        : all_true<std::is_copy_constructible<Ts>::value...>
+    { };
 
-    template<typename T, typename... Ts>
-    struct all_move_constructible<T, Ts...> {
-        static constexpr bool value = 
-            std::is_move_constructible<T>::value &&
-                all_move_constructible<Ts...>::value;
-    };
+    template<typename... Ts>
+    struct all_noexcept_move_constructible 
+        : all_true<std::is_nothrow_move_constructible<Ts>::value...>
+    { };
 
-    template<>
-    struct all_move_constructible<> {
-        static constexpr bool value = true;
-    };
+    template<typename... Ts>
+    struct all_noexcept_copy_constructible 
+        : all_true<std::is_nothrow_copy_constructible<Ts>::value...>
+    { };
+
+    // The smallest unsigned type able to hold `N`, used to discriminate 
+    // between `N` alternatives.
+    template<size_t N>
+    using index_type_t = 
+        std::conditional_t<
+            N <= std::numeric_limits<std::uint8_t>::max(), 
+            std::uint8_t,
+            std::conditional_t<
+                N <= std::numeric_limits<std::uint16_t>::max(), 
+                std::uint16_t,
+                std::conditional_t<
+                    N <= std::numeric_limits<std::uint32_t>::max(),
+                    std::uint32_t,
+                    size_t>>>;
+
+    // Whether a `T` holding variant can be assigned from `U` without 
+    // throwing, either by `T::operator=` or, where `T` isn't assignable 
+    // from `U`, by constructing a new `T`.
+    template<typename T, typename U>
+    struct is_nothrow_assignable_from 
+        : std::integral_constant<
+            bool,
+            std::is_nothrow_constructible<T, U>::value &&
+                (std::is_nothrow_assignable<T&, U>::value ||
+                    !std::is_assignable<T&, U>::value)>
+    { };
+
+    template<size_t I, typename T>
+    struct indexed_type { using type = T; };
+
+    template<typename Is, typename... Ts>
+    struct indexed_types;
+
+    template<size_t... Is, typename... Ts>
+    struct indexed_types<std::index_sequence<Is...>, Ts...> 
+        : indexed_type<Is, Ts>...
+    { };
+
+    // Picks out the base holding index `I`; only ever used unevaluated.
+    template<size_t I, typename T>
+    auto select_indexed(indexed_type<I, T> const&) -> indexed_type<I, T>;
+
+    // The `I`th of `Ts`, found by overload resolution against a single 
+    // flat class rather than by recursing through the pack.
+    template<size_t I, typename... Ts>
+    using type_at_index_t = typename decltype(
+        select_indexed<I>(
+            std::declval<
+                indexed_types<std::index_sequence_for<Ts...>, Ts...>>()))
+        ::type;
 
     template<typename... Ts>
-    struct all_copy_constructible;
+    using first_type_t = type_at_index_t<0, Ts...>;
+
+    template<typename T>
+    struct boxed;
+
+    template<typename T>
+    struct unboxed { using type = T; };
+
+    template<typename T>
+    struct unboxed<boxed<T>> { using type = T; };
+
+    template<typename T>
+    using unboxed_t = typename unboxed<T>::type;
+
+    // The type a variant exposes for alternative `I`, which differs from
+    // the type it stores when that alternative is boxed.
+    template<size_t I, typename... Ts>
+    using alternative_t = unboxed_t<type_at_index_t<I, Ts...>>;
 
     template<typename T, typename... Ts>
-    struct all_copy_constructible<T, Ts...> {
-        static constexpr bool value = 
-            std::is_copy_constructible<T>::value &&
-                all_copy_constructible<Ts...>::value;
-    };
+    using alternative_index_of = type_index_of<0, T, unboxed_t<Ts>...>;
 
-    template<>
-    struct all_copy_constructible<> {
-        static constexpr bool value = true;
-    };
+    // The stored type of the alternative a `U` converts to.
+    template<typename U, typename... Ts>
+    using stored_alternative_t = type_at_index_t<
+        alternative_index_of<typename std::decay<U>::type, Ts...>::value,
+        Ts...>;
+
+    template<size_t I, size_t N>
+    constexpr auto clamp_index() -> size_t {
+        return I < N ? I : N - 1;
+    }
 
+    // Alternatives whose values are equal exactly when their bytes are, so
+    // that comparing and hashing them needs no dispatch.
+    template<typename T>
+    struct is_bytewise_comparable 
+        : std::integral_constant<
+            bool,
+            std::is_integral<T>::value || 
+                std::is_enum<T>::value || 
+                std::is_pointer<T>::value>
+    { };
+
+    // Variants whose whole payload fits in a word and is bytewise 
+    // comparable keep the bytes no alternative is using zeroed, so that 
+    // the payload can be compared and hashed as a single integer.
     template<typename... Ts>
-    struct all_noexcept_move_constructible;
+    struct has_word_payload
+        : std::integral_constant<
+            bool,
+            all_true<is_bytewise_comparable<Ts>::value...>::value &&
+                max_size<Ts...>() <= sizeof(std::uint64_t)>
+    { };
+
+    template<size_t... Ns>
+    constexpr auto product() -> size_t {
+        size_t const values[] = { 1, Ns... };
+        size_t result = 1;
+        for (auto n : values) {
+            result *= n;
+        }
 
-    template<typename T, typename... Ts>
-    struct all_noexcept_move_constructible<T, Ts...> {
-        static constexpr bool value = 
-            std::is_nothrow_move_constructible<T>::value &&
-                all_noexcept_move_constructible<Ts...>::value;
-    };
+        return result;
+    }
+
+    // Recovers the index of variant `J` from position `K` of a flattened
+    // table over variants with `Sizes...` alternatives.
+    template<size_t K, size_t J, size_t... Sizes>
+    constexpr auto unflatten_index() -> size_t {
+        size_t const sizes[] = { Sizes... };
+        size_t stride = 1;
+        for (size_t i = J + 1; i < sizeof...(Sizes); ++i) {
+            stride *= sizes[i];
+        }
+
+        return (K / stride) % sizes[J];
+    }
 
-    template<>
-    struct all_noexcept_move_constructible<> {
-        static constexpr bool value = true;
+    // Grants the dispatchers unchecked access to a variant's alternatives.
+    // `V` carries the value category the visitor sees (const&, & or &&).
+    struct VisitDispatcher {
+        template<size_t I, typename V>
+        static constexpr auto get(V&& storage) 
+            -> decltype(std::forward<V>(storage).template get_unchecked<I>())
+        {
+            return std::forward<V>(storage).template get_unchecked<I>();
+        }
+
+        // As `get`, but a boxed alternative is returned as the box.
+        template<size_t I, typename V>
+        static constexpr auto get_stored(V&& storage) 
+            -> decltype(std::forward<V>(storage).template get_stored<I>())
+        {
+            return std::forward<V>(storage).template get_stored<I>();
+        }
     };
 
-    template<typename... Ts>
-    struct all_noexcept_copy_constructible;
+    // Invokes a visitor on alternative `K` of a single variant.
+    template<typename R, typename F, typename V>
+    struct SingleVisit {
+        using Fn = auto (*)(F&&, V&&) -> R;
 
-    template<typename T, typename... Ts>
-    struct all_noexcept_copy_constructible<T, Ts...> {
-        static constexpr bool value = 
-            std::is_nothrow_copy_constructible<T>::value &&
-                all_noexcept_copy_constructible<Ts...>::value;
+        template<size_t K>
+        static constexpr auto call(F&& f, V&& storage) -> R {
+            return std::forward<F>(f)(
+                VisitDispatcher::get<K>(std::forward<V>(storage))
+            );
+        }
     };
 
-    template<>
-    struct all_noexcept_copy_constructible<> {
-        static constexpr bool value = true;
+    // As `SingleVisit`, but also passes the visitor the alternative's 
+    // index as a `std::integral_constant`.
+    template<typename R, typename F, typename V>
+    struct IndexedVisit {
+        using Fn = auto (*)(F&&, V&&) -> R;
+
+        template<size_t K>
+        static constexpr auto call(F&& f, V&& storage) -> R {
+            return std::forward<F>(f)(
+                std::integral_constant<size_t, K> { },
+                VisitDispatcher::get<K>(std::forward<V>(storage))
+            );
+        }
     };
 
-    template<size_t I, typename... Ts>
-    using type_at_index_t = std::tuple_element_t<I, std::tuple<Ts...>>;
+    // As `IndexedVisit`, but passes boxed alternatives as their boxes. Used
+    // to copy, move and destroy a variant's payload.
+    template<typename R, typename F, typename V>
+    struct StoredVisit {
+        using Fn = auto (*)(F&&, V&&) -> R;
+
+        template<size_t K>
+        static constexpr auto call(F&& f, V&& storage) -> R {
+            return std::forward<F>(f)(
+                std::integral_constant<size_t, K> { },
+                VisitDispatcher::get_stored<K>(std::forward<V>(storage))
+            );
+        }
+    };
 
-    template<typename... Ts>
-    using first_type_t = type_at_index_t<0, Ts...>;
+    // Invokes a visitor on entry `K` of the flattened cross product of 
+    // several variants' alternatives.
+    template<typename R, typename F, typename Sizes, typename... Vs>
+    struct MultiVisit;
+
+    template<typename R, typename F, size_t... Sizes, typename... Vs>
+    struct MultiVisit<R, F, std::index_sequence<Sizes...>, Vs...> {
+        using Fn = auto (*)(F&&, Vs&&...) -> R;
+
+        template<size_t K>
+        static constexpr auto call(F&& f, Vs&&... vs) -> R {
+            return invoke<K>(
+                std::make_index_sequence<sizeof...(Vs)> { },
+                std::forward<F>(f),
+                std::forward<Vs>(vs)...);
+        }
 
-    template<typename T, typename F, typename S, typename... Ts>
-    decltype(auto) apply_visitor(F&& f, S storage, Ts&&... args) {
-        return 
-            std::forward<F>(f)(
-                *reinterpret_cast<T*>(storage), 
-                std::forward<Ts>(args)...
+    private:
+        template<size_t K, size_t... Js>
+        static constexpr auto invoke(std::index_sequence<Js...>, 
+                                     F&& f, 
+                                     Vs&&... vs) 
+            -> R 
+        {
+            return std::forward<F>(f)(
+                VisitDispatcher::get<unflatten_index<K, Js, Sizes...>()>(
+                    std::forward<Vs>(vs))...
             );
+        }
+    };
+
+    // One table per visit instantiation, built at compile time rather 
+    // than on the stack at every call.
+    template<typename D, typename Ks>
+    struct DispatchTable;
+
+    template<typename D, size_t... Ks>
+    struct DispatchTable<D, std::index_sequence<Ks...>> {
+        static constexpr typename D::Fn paths[sizeof...(Ks)] = {
+            &D::template call<Ks>...
+        };
+    };
+
+    template<typename D, size_t... Ks>
+    constexpr typename D::Fn
+        DispatchTable<D, std::index_sequence<Ks...>>::paths[sizeof...(Ks)];
+
+    // Up to this many entries, dispatch uses a switch the compiler can 
+    // inline instead of an indirect call through a `DispatchTable`.
+    constexpr size_t max_switch_alternatives = 8;
+
+    template<typename D, size_t N, typename... Args>
+    constexpr decltype(auto) dispatch(size_t index, 
+                                      std::true_type, 
+                                      Args&&... args) 
+    {
+        switch (index) {
+        case 0: 
+            return D::template call<clamp_index<0, N>()>(
+                std::forward<Args>(args)...);
+        case 1: 
+            return D::template call<clamp_index<1, N>()>(
+                std::forward<Args>(args)...);
+        case 2: 
+            return D::template call<clamp_index<2, N>()>(
+                std::forward<Args>(args)...);
+        case 3: 
+            return D::template call<clamp_index<3, N>()>(
+                std::forward<Args>(args)...);
+        case 4: 
+            return D::template call<clamp_index<4, N>()>(
+                std::forward<Args>(args)...);
+        case 5: 
+            return D::template call<clamp_index<5, N>()>(
+                std::forward<Args>(args)...);
+        case 6: 
+            return D::template call<clamp_index<6, N>()>(
+                std::forward<Args>(args)...);
+        default: 
+            return D::template call<clamp_index<7, N>()>(
+                std::forward<Args>(args)...);
+        }
     }
 
-    template<typename T, typename F, typename S, typename... Ts>
-    decltype(auto) apply_move_visitor(F&& f, S storage, Ts&&... args) {
-        return 
-            std::forward<F>(f)(
-                std::move(*reinterpret_cast<T*>(storage)), 
-                std::forward<Ts>(args)...
-            );
+    template<typename D, size_t N, typename... Args>
+    constexpr decltype(auto) dispatch(size_t index, 
+                                      std::false_type, 
+                                      Args&&... args) 
+    {
+        using Table = DispatchTable<D, std::make_index_sequence<N>>;
+        return (Table::paths[index])(std::forward<Args>(args)...);
+    }
+
+    // Calls `D::call<index>(args...)` for a runtime `index` below `N`.
+    template<typename D, size_t N, typename... Args>
+    constexpr decltype(auto) dispatch(size_t index, Args&&... args) {
+        return dispatch<D, N>(
+            index,
+            std::integral_constant<bool, (N <= max_switch_alternatives)> { },
+            std::forward<Args>(args)...);
+    }
+
+    template<typename D, size_t N, typename... Args>
+    constexpr decltype(auto) dispatch_hinted(size_t index, 
+                                             std::index_sequence<>, 
+                                             Args&&... args) 
+    {
+        return dispatch<D, N>(index, std::forward<Args>(args)...);
+    }
+
+    // As `dispatch`, but first tests `index` against each hinted index in 
+    // turn and calls a match directly, where it can be inlined. Only the 
+    // indices that weren't hinted go through the switch or table.
+    template<typename D, size_t N, size_t I, size_t... Is, typename... Args>
+    constexpr decltype(auto) dispatch_hinted(size_t index, 
+                                             std::index_sequence<I, Is...>, 
+                                             Args&&... args) 
+    {
+        static_assert(I < N, "Hinted alternative index is out of range");
+        if (VARIANT_LIKELY(index == I)) {
+            return D::template call<I>(std::forward<Args>(args)...);
+        }
+
+        return dispatch_hinted<D, N>(
+            index, 
+            std::index_sequence<Is...> { }, 
+            std::forward<Args>(args)...);
     }
 
     struct IncorrectAlternativeError : std::runtime_error {
@@ -126,6 +431,15 @@ namespace variant {
         { }
     };
 
+    [[noreturn]] inline auto incorrect_alternative() -> void {
+#ifdef VARIANT_NO_EXCEPTIONS
+        assert(!"Attempted to access incorrect alternative");
+        std::abort();
+#else
+        throw IncorrectAlternativeError { };
+#endif
+    }
+
     struct NoCopyable {
         NoCopyable() = default;
         NoCopyable(NoCopyable const&) = delete;
@@ -146,100 +460,1264 @@ namespace variant {
         ~Copyable() = default;
     };
 
-    template<typename... Ts>
-    struct VariantStorage {
+    template<typename T>
+    struct in_place_type_t { };
+
+    template<typename T>
+    constexpr in_place_type_t<T> in_place_type { };
+
+    template<size_t I>
+    struct in_place_index_t { };
+
+    template<size_t I>
+    constexpr in_place_index_t<I> in_place_index { };
+
+    template<typename T>
+    struct is_in_place_tag : std::false_type { };
+
+    template<typename T>
+    struct is_in_place_tag<in_place_type_t<T>> : std::true_type { };
+
+    template<size_t I>
+    struct is_in_place_tag<in_place_index_t<I>> : std::true_type { };
+
+    // Parenthesised construction where `T` has a matching constructor, and
+    // list-initialisation otherwise so that aggregates can be built too.
+    template<typename T, typename... Args>
+    auto construct_in(void* p, std::true_type, Args&&... args) -> T* {
+        return new (p) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T, typename... Args>
+    auto construct_in(void* p, std::false_type, Args&&... args) -> T* {
+        return new (p) T { std::forward<Args>(args)... };
+    }
+
+    template<typename T, typename... Args>
+    using is_parenthesised = std::integral_constant<
+        bool, 
+        std::is_constructible<T, Args...>::value>;
+
+    template<typename T, typename... Args>
+    auto construct_at(void* p, Args&&... args) -> T* {
+        return construct_in<T>(
+            p, 
+            is_parenthesised<T, Args...> { }, 
+            std::forward<Args>(args)...);
+    }
+
+    template<bool Parenthesised, typename T, typename... Args>
+    struct is_nothrow_constructible_in 
+        : std::is_nothrow_constructible<T, Args...> 
+    { };
+
+    template<typename T, typename... Args>
+    struct is_nothrow_constructible_in<false, T, Args...> 
+        : std::integral_constant<
+            bool, 
+            noexcept(T { std::declval<Args>()... })> 
+    { };
+
+    // Whether `construct_at<T>(p, args...)` can't throw.
+    template<typename T, typename... Args>
+    using is_nothrow_constructible_at = 
+        is_nothrow_constructible_in<
+            is_parenthesised<T, Args...>::value, T, Args...>;
+
+    template<typename T, typename... Args>
+    auto make_value(std::true_type, Args&&... args) -> T {
+        return T(std::forward<Args>(args)...);
+    }
+
+    template<typename T, typename... Args>
+    auto make_value(std::false_type, Args&&... args) -> T {
+        return T { std::forward<Args>(args)... };
+    }
+
+    template<typename B, typename... Args>
+    struct is_self_argument : std::false_type { };
+
+    template<typename B, typename A>
+    struct is_self_argument<B, A> 
+        : std::is_same<typename std::decay<A>::type, B> 
+    { };
+
+    // Marks an alternative to be held on the heap, so that a large but 
+    // rarely held type doesn't set the size of every variant. The variant
+    // only ever shows the `T` itself: `get<T>`, `is_alternative<T>` and 
+    // visitors see no sign of the box.
+    //
+    // Copying copies the `T`. Moving only moves the pointer, so a 
+    // moved-from variant holding a boxed alternative may only be assigned 
+    // to or destroyed: `get`, `visit`, comparing or hashing it asserts.
+    template<typename T>
+    struct boxed {
+        template<
+            typename... Args,
+            typename std::enable_if<
+                !is_self_argument<boxed, Args...>::value>::type* = nullptr>
+        boxed(Args&&... args) :
+            ptr_ { 
+                create(is_parenthesised<T, Args...> { }, 
+                       std::forward<Args>(args)...) 
+            }
+        { }
+
+        boxed(boxed const& other) :
+            ptr_ { new T(*other) }
+        { }
+
+        boxed(boxed&& other) noexcept :
+            ptr_ { other.ptr_ }
+        {
+            other.ptr_ = nullptr;
+        }
+
+        boxed& operator=(boxed const& other) {
+            if (ptr_ && other.ptr_) {
+                *ptr_ = *other;
+            }
+            else {
+                boxed tmp { other };
+                std::swap(ptr_, tmp.ptr_);
+            }
+
+            return *this;
+        }
+
+        boxed& operator=(boxed&& other) noexcept {
+            std::swap(ptr_, other.ptr_);
+            return *this;
+        }
+
+        // Assigns into the existing `T` rather than allocating another.
         template<
             typename U,
             typename std::enable_if<
-                !std::is_same<
-                    typename std::decay<U>::type,
-                    VariantStorage>::value>::type* = nullptr>
-        VariantStorage(U&& val)
-            noexcept(
-                noexcept(typename std::decay<U>::type { std::declval<U>() })
-            )
+                !std::is_same<typename std::decay<U>::type, boxed>::value &&
+                std::is_assignable<T&, U>::value>::type* = nullptr>
+        boxed& operator=(U&& val) {
+            if (ptr_) {
+                *ptr_ = std::forward<U>(val);
+            }
+            else {
+                ptr_ = new T(std::forward<U>(val));
+            }
+
+            return *this;
+        }
+
+        ~boxed() {
+            delete ptr_;
+        }
+
+        // A box that has been moved from holds nothing until it's 
+        // assigned to.
+        T& operator*() {
+            assert(ptr_ && "boxed value used after being moved from");
+            return *ptr_;
+        }
+
+        T const& operator*() const {
+            assert(ptr_ && "boxed value used after being moved from");
+            return *ptr_;
+        }
+
+    private:
+        template<typename... Args>
+        static auto create(std::true_type, Args&&... args) -> T* {
+            return new T(std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        static auto create(std::false_type, Args&&... args) -> T* {
+            return new T { std::forward<Args>(args)... };
+        }
+
+        T* ptr_;
+    };
+
+    // `T`, or `boxed<T>` when a `T` is larger than `Limit` bytes.
+    template<size_t Limit, typename T>
+    using box_if_larger_t = 
+        std::conditional_t<(sizeof(T) > Limit), boxed<T>, T>;
+
+    template<typename T>
+    constexpr auto unbox(T& val) -> T& {
+        return val;
+    }
+
+    template<typename T>
+    constexpr auto unbox(T const& val) -> T const& {
+        return val;
+    }
+
+    template<typename T>
+    auto unbox(boxed<T>& val) -> T& {
+        return *val;
+    }
+
+    template<typename T>
+    auto unbox(boxed<T> const& val) -> T const& {
+        return *val;
+    }
+
+    // Tags the constructor that builds a storage's payload from another 
+    // storage, for the copy and move constructor layers.
+    struct ConstructFrom { };
+
+    // A union member holding a `T`, followed by `Pad` bytes that are 
+    // always zero.
+    template<typename T, size_t Pad>
+    struct UnionSlot {
+        template<typename... Args>
+        constexpr UnionSlot(std::true_type, Args&&... args) :
+            value(std::forward<Args>(args)...),
+            pad { }
+        { }
+
+        template<typename... Args>
+        constexpr UnionSlot(std::false_type, Args&&... args) :
+            value { std::forward<Args>(args)... },
+            pad { }
+        { }
+
+        T value;
+        unsigned char pad[Pad];
+    };
+
+    template<typename T>
+    struct UnionSlot<T, 0> {
+        template<typename... Args>
+        constexpr UnionSlot(std::true_type, Args&&... args) :
+            value(std::forward<Args>(args)...)
+        { }
+
+        template<typename... Args>
+        constexpr UnionSlot(std::false_type, Args&&... args) :
+            value { std::forward<Args>(args)... }
+        { }
+
+        T value;
+    };
+
+    // Storage for trivially destructible alternatives. Unlike placement 
+    // new into raw bytes, initialising a union member is allowed in a 
+    // constant expression, so variants using this are literal types. 
+    // Where `Width` is non-zero, each alternative is padded out to that 
+    // many zeroed bytes.
+    //
+    // The alternatives are split into a balanced tree of nested unions, so
+    // reaching any one of them instantiates `log2(sizeof...(Ts))` members 
+    // rather than one per alternative ahead of it.
+    template<size_t Width, typename... Ts>
+    union RecursiveUnion;
+
+    // A union of the `Ts` at `Offset + Is...`.
+    template<size_t Width, size_t Offset, typename Is, typename... Ts>
+    struct sub_union;
+
+    template<size_t Width, size_t Offset, size_t... Is, typename... Ts>
+    struct sub_union<Width, Offset, std::index_sequence<Is...>, Ts...> {
+        using type = 
+            RecursiveUnion<Width, type_at_index_t<Offset + Is, Ts...>...>;
+    };
+
+    template<size_t Width, typename T>
+    union RecursiveUnion<Width, T> {
+        constexpr RecursiveUnion() :
+            empty_ { }
+        { }
+
+        template<typename... Args>
+        constexpr explicit RecursiveUnion(in_place_index_t<0>, 
+                                          Args&&... args) 
         :
-            type_index_ { 
-                type_index_of<0, typename std::decay<U>::type, Ts...>::value 
-            } 
+            head_ { 
+                is_parenthesised<T, Args...> { }, 
+                std::forward<Args>(args)... 
+            }
+        { }
+
+        template<typename... Args>
+        auto emplace(in_place_index_t<0> tag, Args&&... args) -> T& {
+            auto* p = ::new (static_cast<void*>(this)) 
+                RecursiveUnion(tag, std::forward<Args>(args)...);
+            return p->get(tag);
+        }
+
+        constexpr auto get(in_place_index_t<0>) & -> T& {
+            return head_.value;
+        }
+
+        constexpr auto get(in_place_index_t<0>) const & -> T const& {
+            return head_.value;
+        }
+
+    private:
+        static constexpr size_t pad = 
+            Width > sizeof(T) ? Width - sizeof(T) : 0;
+
+        char empty_;
+        UnionSlot<T, pad> head_;
+    };
+
+    template<size_t Width, typename... Ts>
+    union RecursiveUnion {
+    private:
+        static constexpr size_t half = sizeof...(Ts) / 2;
+
+        using Left = typename sub_union<
+            Width, 0, std::make_index_sequence<half>, Ts...>::type;
+
+        using Right = typename sub_union<
+            Width, 
+            half, 
+            std::make_index_sequence<sizeof...(Ts) - half>, 
+            Ts...>::type;
+
+    public:
+        constexpr RecursiveUnion() :
+            empty_ { }
+        { }
+
+        template<
+            size_t I, 
+            typename std::enable_if<(I < half), int>::type = 0,
+            typename... Args>
+        constexpr explicit RecursiveUnion(in_place_index_t<I> tag, 
+                                          Args&&... args) 
+        :
+            left_ { tag, std::forward<Args>(args)... }
+        { }
+
+        template<
+            size_t I, 
+            typename std::enable_if<(half <= I), int>::type = 0,
+            typename... Args>
+        constexpr explicit RecursiveUnion(in_place_index_t<I>, 
+                                          Args&&... args) 
+        :
+            right_ { in_place_index<I - half>, std::forward<Args>(args)... }
+        { }
+
+        // Replaces whichever member is active with alternative `I`. 
+        template<size_t I, typename... Args>
+        auto emplace(in_place_index_t<I> tag, Args&&... args) 
+            -> type_at_index_t<I, Ts...>& 
         {
-            new (get_storage()) typename std::decay<U>::type { 
-                std::forward<U>(val) 
-            };
+            auto* p = ::new (static_cast<void*>(this)) 
+                RecursiveUnion(tag, std::forward<Args>(args)...);
+            return p->get(tag);
         }
 
-        VariantStorage(VariantStorage const& other)
-            noexcept(all_noexcept_copy_constructible<Ts...>::value)
+        template<
+            size_t I, 
+            typename std::enable_if<(I < half), int>::type = 0>
+        constexpr decltype(auto) get(in_place_index_t<I> tag) & {
+            return left_.get(tag);
+        }
+
+        template<
+            size_t I, 
+            typename std::enable_if<(I < half), int>::type = 0>
+        constexpr decltype(auto) get(in_place_index_t<I> tag) const & {
+            return left_.get(tag);
+        }
+
+        template<
+            size_t I, 
+            typename std::enable_if<(half <= I), int>::type = 0>
+        constexpr decltype(auto) get(in_place_index_t<I>) & {
+            return right_.get(in_place_index<I - half>);
+        }
+
+        template<
+            size_t I, 
+            typename std::enable_if<(half <= I), int>::type = 0>
+        constexpr decltype(auto) get(in_place_index_t<I>) const & {
+            return right_.get(in_place_index<I - half>);
+        }
+
+    private:
+        char empty_;
+        Left left_;
+        Right right_;
+    };
+
+    // Storage for alternatives that need their destructors run, which a
+    // union can't do without knowing which member is active.
+    template<typename... Ts>
+    struct AlignedStorage {
+        AlignedStorage() = default;
+
+        template<size_t I, typename... Args>
+        explicit AlignedStorage(in_place_index_t<I> tag, Args&&... args) {
+            emplace(tag, std::forward<Args>(args)...);
+        }
+
+        template<size_t I, typename... Args>
+        auto emplace(in_place_index_t<I>, Args&&... args) 
+            -> type_at_index_t<I, Ts...>& 
+        {
+            return *construct_at<type_at_index_t<I, Ts...>>(
+                static_cast<void*>(&storage_), 
+                std::forward<Args>(args)...);
+        }
+
+        template<size_t I>
+        auto get(in_place_index_t<I>) & -> type_at_index_t<I, Ts...>& {
+            return *reinterpret_cast<type_at_index_t<I, Ts...>*>(&storage_);
+        }
+
+        template<size_t I>
+        auto get(in_place_index_t<I>) const & 
+            -> type_at_index_t<I, Ts...> const& 
+        {
+            return *reinterpret_cast<type_at_index_t<I, Ts...> const*>(
+                &storage_);
+        }
+
+    private:
+        typename std::aligned_storage<max_size<Ts...>(),
+                                      max_align<Ts...>()>::type storage_;
+    };
+
+    template<typename... Ts>
+    using variant_storage_t = 
+        std::conditional_t<
+            all_true<std::is_trivially_destructible<Ts>::value...>::value,
+            RecursiveUnion<
+                has_word_payload<Ts...>::value ? max_size<Ts...>() : 0, 
+                Ts...>,
+            AlignedStorage<Ts...>>;
+
+    // Two of storage `S`, one holding the value and one spare, so that a
+    // new value can be built beside the old one, which is only destroyed 
+    // once that has succeeded.
+    template<typename S>
+    struct DoubleBuffered {
+        DoubleBuffered() = default;
+
+        template<size_t I, typename... Args>
+        explicit DoubleBuffered(in_place_index_t<I> tag, Args&&... args) {
+            emplace(tag, std::forward<Args>(args)...);
+        }
+
+        template<size_t I, typename... Args>
+        decltype(auto) emplace(in_place_index_t<I> tag, Args&&... args) {
+            return buffers_[active_].emplace(
+                tag, 
+                std::forward<Args>(args)...);
+        }
+
+        // Builds a value in the spare buffer, leaving the active one be.
+        template<size_t I, typename... Args>
+        decltype(auto) emplace_spare(in_place_index_t<I> tag, 
+                                     Args&&... args) 
+        {
+            return buffers_[active_ ^ 1].emplace(
+                tag, 
+                std::forward<Args>(args)...);
+        }
+
+        // Makes the spare buffer the active one.
+        auto flip() -> void {
+            active_ ^= 1;
+        }
+
+        template<size_t I>
+        decltype(auto) get(in_place_index_t<I> tag) & {
+            return buffers_[active_].get(tag);
+        }
+
+        template<size_t I>
+        decltype(auto) get(in_place_index_t<I> tag) const & {
+            return buffers_[active_].get(tag);
+        }
+
+    private:
+        S buffers_[2];
+        unsigned char active_ = 0;
+    };
+
+    template<typename... Ts>
+    struct Variant;
+
+    // What an instrumentation policy is told about, per alternative.
+    // `Construct` covers a variant being given a value directly: by a 
+    // converting or in-place constructor, a converting assignment or 
+    // `emplace`. `Copy` and `Move` cover construction and assignment from 
+    // another variant. Assigning to the alternative already held builds 
+    // nothing, so it isn't counted, and each of these pairs with a 
+    // `Destroy`.
+    enum class VariantEvent { Construct, Copy, Move, Destroy, Visit };
+
+    // The default policy, which records nothing. Variants using it keep 
+    // their trivial special members and pay nothing for the hooks.
+    struct NoInstrumentation {
+        static constexpr bool enabled = false;
+
+        template<typename V>
+        static constexpr auto record(VariantEvent, size_t) -> void { }
+    };
+
+    // Selects the instrumentation policy for `Variant<Ts...>`. Specialise
+    // it, before the variant is first used, to have a policy such as 
+    // `CountingInstrumentation` (see "variant/instrumentation.hpp") told 
+    // about every event. Instrumented variants have no trivial special 
+    // members, so that copies, moves and destructions can be seen.
+    template<typename... Ts>
+    struct variant_instrumentation {
+        using type = NoInstrumentation;
+    };
+
+    template<typename... Ts>
+    using instrumentation_t = typename variant_instrumentation<Ts...>::type;
+
+    template<typename... Ts>
+    using is_instrumented = 
+        std::integral_constant<bool, instrumentation_t<Ts...>::enabled>;
+
+    // The alternatives a plain `visit` of `Variant<Ts...>` tests for before
+    // dispatching, as a `std::index_sequence` of indices in the order to 
+    // test them. Specialise it for variants whose values are nearly all 
+    // one or two alternatives; `likely_alternatives` (see 
+    // "variant/instrumentation.hpp") suggests which from the visits an 
+    // instrumented build has counted.
+    template<typename... Ts>
+    struct variant_visit_hints {
+        using type = std::index_sequence<>;
+    };
+
+    template<typename... Ts>
+    using visit_hints_t = typename variant_visit_hints<Ts...>::type;
+
+    // How a variant replaces its value with a different alternative, 
+    // whether by assignment or `emplace`. Assigning to the alternative 
+    // already held always uses that alternative's own assignment.
+    //
+    // `Direct` destroys the old value and builds the new one in place. It 
+    // costs nothing extra, but if the new value's constructor throws 
+    // there is no value left to fall back on, so it calls 
+    // `std::terminate`. Suits variants whose alternatives can't throw.
+    //
+    // `Temporary` does the same where the constructor can't throw. Where 
+    // it can, the new value is built in a temporary first and then moved 
+    // in, so a throw leaves the old value untouched. That costs a move, 
+    // which should be `noexcept`: a move that throws still terminates.
+    //
+    // `DoubleBuffer` keeps two buffers and builds the new value in the 
+    // spare one before destroying the old, so a throw leaves the old 
+    // value untouched with no extra move. It doubles the payload's size.
+    //
+    // `emplace` never builds through a temporary: under `Direct` and 
+    // `Temporary` it destroys the old value and constructs in place, so 
+    // it terminates if the constructor throws. Only `DoubleBuffer` keeps 
+    // the old value.
+    enum class AssignStrategy { Direct, Temporary, DoubleBuffer };
+
+    template<AssignStrategy S>
+    using assign_strategy_t = std::integral_constant<AssignStrategy, S>;
+
+    // The `AssignStrategy` for `Variant<Ts...>`. Specialise it, before the
+    // variant is first used, to choose another.
+    template<typename... Ts>
+    struct variant_assign_strategy 
+        : assign_strategy_t<AssignStrategy::Temporary> 
+    { };
+
+    template<typename... Ts>
+    using variant_buffer_t = 
+        std::conditional_t<
+            variant_assign_strategy<Ts...>::value == 
+                AssignStrategy::DoubleBuffer,
+            DoubleBuffered<variant_storage_t<Ts...>>,
+            variant_storage_t<Ts...>>;
+
+    template<typename... Ts>
+    constexpr auto record_event(VariantEvent event, size_t index) -> void {
+        instrumentation_t<Ts...>::template record<Variant<Ts...>>(
+            event, index);
+    }
+
+    // The payload, discriminator and everything that doesn't depend on 
+    // whether the alternatives are trivial. The special members are layered 
+    // on top of this so that each one stays trivial when all of `Ts` allow.
+    template<typename... Ts>
+    struct VariantStorageBase {
+        // The payload is constructed here rather than in the layers above
+        // so that, if construction throws, no layer's destructor runs on 
+        // storage that was never initialised.
+        template<size_t I, typename... Args>
+        constexpr explicit VariantStorageBase(in_place_index_t<I> tag, 
+                                              Args&&... args) 
         :
-            type_index_ { other.type_index_ }
+            storage_ { tag, std::forward<Args>(args)... },
+            type_index_ { I }
+        { 
+            record_event<Ts...>(VariantEvent::Construct, I);
+        }
+
+        template<typename V>
+        VariantStorageBase(ConstructFrom, V&& other) {
+            construct_from(std::forward<V>(other));
+        }
+
+        template<typename T>
+        constexpr auto is_alternative() const -> bool {
+            return alternative_index_of<T, Ts...>::value == type_index_;
+        }
+
+        constexpr auto index() const -> size_t {
+            return type_index_;
+        }
+
+        template<typename T>
+        constexpr auto get() & -> T& {
+            return get<alternative_index_of<T, Ts...>::value>();
+        }
+
+        template<typename T>
+        constexpr auto get() const & -> T const& {
+            return get<alternative_index_of<T, Ts...>::value>();
+        }
+
+        template<typename T>
+        constexpr auto get() && -> T&& {
+            return std::move(get<T>());
+        }
+
+        template<size_t I>
+        constexpr auto get() & -> alternative_t<I, Ts...>& {
+            if (I != type_index_) {
+                incorrect_alternative();
+            }
+
+            return get_unchecked<I>();
+        }
+
+        template<size_t I>
+        constexpr auto get() const & 
+            -> alternative_t<I, Ts...> const& 
         {
-            other.visit(
-                [this](auto const& val) {
-                    using T = typename std::decay<decltype(val)>::type;
-                    new (static_cast<void*>(get_storage())) T { val };
-                }
+            if (I != type_index_) {
+                incorrect_alternative();
+            }
+
+            return get_unchecked<I>();
+        }
+
+        template<size_t I>
+        constexpr auto get() && -> alternative_t<I, Ts...>&& {
+            return std::move(get<I>());
+        }
+
+        // As `get`, but without checking the alternative outside of debug
+        // builds. The caller must already know `I` is active.
+        template<size_t I>
+        constexpr auto unsafe_get() & -> alternative_t<I, Ts...>& {
+            assert(I == type_index_);
+            return get_unchecked<I>();
+        }
+
+        template<size_t I>
+        constexpr auto unsafe_get() const & 
+            -> alternative_t<I, Ts...> const& 
+        {
+            assert(I == type_index_);
+            return get_unchecked<I>();
+        }
+
+        template<size_t I>
+        constexpr auto unsafe_get() && -> alternative_t<I, Ts...>&& {
+            assert(I == type_index_);
+            return std::move(get_unchecked<I>());
+        }
+
+        template<typename T>
+        constexpr auto unsafe_get() & -> T& {
+            return unsafe_get<alternative_index_of<T, Ts...>::value>();
+        }
+
+        template<typename T>
+        constexpr auto unsafe_get() const & -> T const& {
+            return unsafe_get<alternative_index_of<T, Ts...>::value>();
+        }
+
+        template<typename T>
+        constexpr auto unsafe_get() && -> T&& {
+            return std::move(*this).template 
+                unsafe_get<alternative_index_of<T, Ts...>::value>();
+        }
+
+        template<typename F>
+        constexpr decltype(auto) visit(F&& visitor) const & {
+            return visit_in_order(
+                visit_hints_t<Ts...> { }, 
+                std::forward<F>(visitor));
+        }
+
+        template<typename F>
+        constexpr decltype(auto) visit(F&& visitor) & {
+            return visit_in_order(
+                visit_hints_t<Ts...> { }, 
+                std::forward<F>(visitor));
+        }
+
+        template<typename F>
+        constexpr decltype(auto) visit(F&& visitor) && {
+            return std::move(*this).visit_in_order(
+                visit_hints_t<Ts...> { }, 
+                std::forward<F>(visitor));
+        }
+
+        // As `visit`, but tests for the alternatives at `Is`, in order, 
+        // before dispatching on the rest, so that a visit of one of them 
+        // costs a compare and a direct call. It pays off where the hinted 
+        // alternatives cover nearly every value; with less skew the extra,
+        // poorly predicted branch costs more than the dispatch it avoids.
+        template<size_t... Is, typename F>
+        constexpr decltype(auto) visit_hinted(F&& visitor) const & {
+            return visit_in_order(
+                std::index_sequence<Is...> { }, 
+                std::forward<F>(visitor));
+        }
+
+        template<size_t... Is, typename F>
+        constexpr decltype(auto) visit_hinted(F&& visitor) & {
+            return visit_in_order(
+                std::index_sequence<Is...> { }, 
+                std::forward<F>(visitor));
+        }
+
+        template<size_t... Is, typename F>
+        constexpr decltype(auto) visit_hinted(F&& visitor) && {
+            return std::move(*this).visit_in_order(
+                std::index_sequence<Is...> { }, 
+                std::forward<F>(visitor));
+        }
+
+        // As `visit_hinted`, naming the likely alternatives by type.
+        template<typename... Us, typename F>
+        constexpr decltype(auto) visit_likely(F&& visitor) const & {
+            return visit_hinted<alternative_index_of<Us, Ts...>::value...>(
+                std::forward<F>(visitor));
+        }
+
+        template<typename... Us, typename F>
+        constexpr decltype(auto) visit_likely(F&& visitor) & {
+            return visit_hinted<alternative_index_of<Us, Ts...>::value...>(
+                std::forward<F>(visitor));
+        }
+
+        template<typename... Us, typename F>
+        constexpr decltype(auto) visit_likely(F&& visitor) && {
+            return std::move(*this).template 
+                visit_hinted<alternative_index_of<Us, Ts...>::value...>(
+                    std::forward<F>(visitor));
+        }
+
+    protected:
+        template<size_t I, typename... Args>
+        auto construct(Args&&... args) -> alternative_t<I, Ts...>& {
+            auto& val = storage_.emplace(
+                in_place_index<I>, 
+                std::forward<Args>(args)...);
+            type_index_ = I;
+
+            return unbox(val);
+        }
+
+        // Constructs the same alternative as `other` holds, copying or 
+        // moving depending on `other`'s value category.
+        template<typename V>
+        auto construct_from(V&& other) -> void {
+            visit_indexed(
+                [this](auto index, auto&& val) {
+                    construct<decltype(index)::value>(
+                        std::forward<decltype(val)>(val));
+                },
+                std::forward<V>(other)
             );
+            record_event<Ts...>(transfer_event<V>(), type_index_);
         }
 
-        VariantStorage(VariantStorage&& other)
-            noexcept(all_noexcept_move_constructible<Ts...>::value)
-        :
-            type_index_ { other.type_index_ }
-        {
-            std::move(other).visit(
-                [this](auto&& val) {
-                    static_assert(
-                        !std::is_const<
-                            std::remove_reference_t<decltype(val)>>::value,
-                        "Cannot be const");
-                    using T = typename std::decay<decltype(val)>::type;
-                    new (static_cast<void*>(get_storage())) T { 
-                        std::move(val) 
-                    };
-                }
+        // Assigns alternative `I` from `val`. When `I` is already active 
+        // this uses the alternative's own assignment operator, keeping 
+        // any resources (e.g. a string's buffer) it already owns. `event` 
+        // is recorded only if a new value is built, so that every 
+        // construction still pairs with a `Destroy`.
+        template<size_t I, typename U>
+        auto assign(U&& val, VariantEvent event) -> void {
+            using T = type_at_index_t<I, Ts...>;
+            if (type_index_ == I) {
+                assign_active<I>(
+                    std::forward<U>(val), 
+                    event,
+                    std::is_assignable<T&, U> { });
+            }
+            else {
+                replace<I>(std::forward<U>(val));
+                record_event<Ts...>(event, I);
+            }
+        }
+
+        // Replaces the current value with alternative `I` built from 
+        // `args`, as the variant's `AssignStrategy` says.
+        template<size_t I, typename... Args>
+        auto replace(Args&&... args) -> alternative_t<I, Ts...>& {
+            return replace_with<I>(
+                assign_strategy_t<variant_assign_strategy<Ts...>::value> { },
+                is_nothrow_constructible_at<
+                    type_at_index_t<I, Ts...>, Args...> { },
+                std::forward<Args>(args)...);
+        }
+
+        // As `replace`, but always built directly in the storage, for 
+        // `emplace`. Only `DoubleBuffer` has somewhere else to build it, 
+        // so under the other strategies the old value is already gone 
+        // when the constructor runs, and a throw terminates.
+        template<size_t I, typename... Args>
+        auto replace_in_place(Args&&... args) -> alternative_t<I, Ts...>& {
+            using Strategy = std::conditional_t<
+                variant_assign_strategy<Ts...>::value == 
+                    AssignStrategy::DoubleBuffer,
+                assign_strategy_t<AssignStrategy::DoubleBuffer>,
+                assign_strategy_t<AssignStrategy::Direct>>;
+
+            return replace_with<I>(
+                Strategy { }, 
+                std::true_type { }, 
+                std::forward<Args>(args)...);
+        }
+
+        template<typename V>
+        auto assign_from(V&& other) -> void {
+            visit_indexed(
+                [this](auto index, auto&& val) {
+                    assign<decltype(index)::value>(
+                        std::forward<decltype(val)>(val),
+                        transfer_event<V>());
+                },
+                std::forward<V>(other)
             );
         }
 
-        ~VariantStorage() {
-            visit(
-                [](auto& val) {
+        auto destroy() noexcept -> void {
+            record_event<Ts...>(VariantEvent::Destroy, type_index_);
+            visit_indexed(
+                [](auto, auto& val) {
                     using T = typename std::decay<decltype(val)>::type;
                     val.~T();
-                }
+                },
+                *this
             );
         }
 
-        VariantStorage& operator=(VariantStorage const& other) 
-            noexcept(all_noexcept_copy_constructible<Ts...>::value)
+    private:
+        friend struct VisitDispatcher;
+
+        template<typename Hints, typename F>
+        constexpr decltype(auto) visit_in_order(Hints hints, 
+                                                F&& visitor) const & 
         {
-            this->~VariantStorage();
-            other.visit(
-                [this](auto const& val) {
-                    using T = typename std::decay<decltype(val)>::type;
-                    new (static_cast<void*>(get_storage())) T { val };
-                    type_index_ = type_index_of<0, T, Ts...>::value;
-                }
-            );
+            using R = std::result_of_t<F(first_type_t<unboxed_t<Ts>...> const&)>;
+            record_event<Ts...>(VariantEvent::Visit, type_index_);
+            using D = SingleVisit<R, F, VariantStorageBase const&>;
+            return dispatch_hinted<D, sizeof...(Ts)>(
+                type_index_,
+                hints,
+                std::forward<F>(visitor), 
+                *this);
+        }
 
-            return *this;
+        template<typename Hints, typename F>
+        constexpr decltype(auto) visit_in_order(Hints hints, 
+                                                F&& visitor) & 
+        {
+            using R = std::result_of_t<F(first_type_t<unboxed_t<Ts>...>&)>;
+            record_event<Ts...>(VariantEvent::Visit, type_index_);
+            using D = SingleVisit<R, F, VariantStorageBase&>;
+            return dispatch_hinted<D, sizeof...(Ts)>(
+                type_index_,
+                hints,
+                std::forward<F>(visitor), 
+                *this);
+        }
+
+        template<typename Hints, typename F>
+        constexpr decltype(auto) visit_in_order(Hints hints, 
+                                                F&& visitor) && 
+        {
+            using R = std::result_of_t<F(first_type_t<unboxed_t<Ts>...>&&)>;
+            record_event<Ts...>(VariantEvent::Visit, type_index_);
+            using D = SingleVisit<R, F, VariantStorageBase>;
+            return dispatch_hinted<D, sizeof...(Ts)>(
+                type_index_,
+                hints,
+                std::forward<F>(visitor), 
+                std::move(*this));
+        }
+
+        // Whether taking `other`'s value copies or moves it.
+        template<typename V>
+        static constexpr auto transfer_event() -> VariantEvent {
+            return std::is_lvalue_reference<V>::value 
+                ? VariantEvent::Copy 
+                : VariantEvent::Move;
+        }
+
+        template<typename F, typename V>
+        static auto visit_indexed(F&& f, V&& storage) -> void {
+            dispatch<StoredVisit<void, F, V>, sizeof...(Ts)>(
+                storage.type_index_,
+                std::forward<F>(f),
+                std::forward<V>(storage));
+        }
+
+        template<size_t I, typename U>
+        auto assign_active(U&& val, VariantEvent, std::true_type) -> void {
+            get_stored<I>() = std::forward<U>(val);
+        }
+
+        template<size_t I, typename U>
+        auto assign_active(U&& val, VariantEvent event, std::false_type) 
+            -> void 
+        {
+            replace<I>(std::forward<U>(val));
+            record_event<Ts...>(event, I);
+        }
+
+        template<size_t I, typename Nothrow, typename... Args>
+        auto replace_with(assign_strategy_t<AssignStrategy::Direct>, 
+                          Nothrow, 
+                          Args&&... args) 
+            -> alternative_t<I, Ts...>& 
+        {
+            destroy();
+            return construct_or_terminate<I>(std::forward<Args>(args)...);
         }
 
-        VariantStorage& operator=(VariantStorage&& other) 
+        template<size_t I, typename... Args>
+        auto replace_with(assign_strategy_t<AssignStrategy::Temporary>, 
+                          std::true_type, 
+                          Args&&... args) 
+            -> alternative_t<I, Ts...>& 
+        {
+            destroy();
+            return construct<I>(std::forward<Args>(args)...);
+        }
+
+        template<size_t I, typename... Args>
+        auto replace_with(assign_strategy_t<AssignStrategy::Temporary>, 
+                          std::false_type, 
+                          Args&&... args) 
+            -> alternative_t<I, Ts...>& 
+        {
+            using T = type_at_index_t<I, Ts...>;
+            auto temporary = make_value<T>(
+                is_parenthesised<T, Args...> { }, 
+                std::forward<Args>(args)...);
+            destroy();
+            return construct_or_terminate<I>(std::move(temporary));
+        }
+
+        template<size_t I, typename Nothrow, typename... Args>
+        auto replace_with(assign_strategy_t<AssignStrategy::DoubleBuffer>, 
+                          Nothrow, 
+                          Args&&... args) 
+            -> alternative_t<I, Ts...>& 
+        {
+            auto& val = storage_.emplace_spare(
+                in_place_index<I>, 
+                std::forward<Args>(args)...);
+            destroy();
+            storage_.flip();
+            type_index_ = I;
+
+            return unbox(val);
+        }
+
+        // For when the old value is already gone and a throw would leave 
+        // `type_index_` naming it.
+        template<size_t I, typename... Args>
+        auto construct_or_terminate(Args&&... args) noexcept 
+            -> alternative_t<I, Ts...>& 
+        {
+            return construct<I>(std::forward<Args>(args)...);
+        }
+
+        template<size_t I>
+        constexpr auto get_unchecked() & -> alternative_t<I, Ts...>& {
+            return unbox(storage_.get(in_place_index<I>));
+        }
+
+        template<size_t I>
+        constexpr auto get_unchecked() const & 
+            -> alternative_t<I, Ts...> const& 
+        {
+            return unbox(storage_.get(in_place_index<I>));
+        }
+
+        template<size_t I>
+        constexpr auto get_unchecked() && -> alternative_t<I, Ts...>&& {
+            return std::move(get_unchecked<I>());
+        }
+
+        template<size_t I>
+        constexpr auto get_stored() & -> type_at_index_t<I, Ts...>& {
+            return storage_.get(in_place_index<I>);
+        }
+
+        template<size_t I>
+        constexpr auto get_stored() const & 
+            -> type_at_index_t<I, Ts...> const& 
+        {
+            return storage_.get(in_place_index<I>);
+        }
+
+        template<size_t I>
+        constexpr auto get_stored() && -> type_at_index_t<I, Ts...>&& {
+            return std::move(get_stored<I>());
+        }
+
+        // The discriminator follows the payload so that it occupies what 
+        // would otherwise be tail padding.
+        variant_buffer_t<Ts...> storage_;
+        index_type_t<sizeof...(Ts)> type_index_;
+    };
+
+    template<bool Trivial, typename... Ts>
+    struct VariantDestructor;
+
+    template<typename... Ts>
+    struct VariantDestructor<true, Ts...> : VariantStorageBase<Ts...> {
+        using VariantStorageBase<Ts...>::VariantStorageBase;
+    };
+
+    template<typename... Ts>
+    struct VariantDestructor<false, Ts...> : VariantStorageBase<Ts...> {
+        using VariantStorageBase<Ts...>::VariantStorageBase;
+
+        VariantDestructor(VariantDestructor const&) = default;
+        VariantDestructor(VariantDestructor&&) = default;
+        VariantDestructor& operator=(VariantDestructor const&) = default;
+        VariantDestructor& operator=(VariantDestructor&&) = default;
+
+        ~VariantDestructor() {
+            this->destroy();
+        }
+    };
+
+    template<typename... Ts>
+    using VariantDestructorBase = 
+        VariantDestructor<
+            all_true<
+                !is_instrumented<Ts...>::value,
+                std::is_trivially_destructible<Ts>::value...>::value,
+            Ts...>;
+
+    template<bool Trivial, typename... Ts>
+    struct VariantCopyConstructor;
+
+    template<typename... Ts>
+    struct VariantCopyConstructor<true, Ts...> 
+        : VariantDestructorBase<Ts...> 
+    {
+        using VariantDestructorBase<Ts...>::VariantDestructorBase;
+    };
+
+    template<typename... Ts>
+    struct VariantCopyConstructor<false, Ts...> 
+        : VariantDestructorBase<Ts...> 
+    {
+        using VariantDestructorBase<Ts...>::VariantDestructorBase;
+
+        VariantCopyConstructor(VariantCopyConstructor const& other)
+            noexcept(all_noexcept_copy_constructible<Ts...>::value)
+        :
+            VariantDestructorBase<Ts...> { ConstructFrom { }, other }
+        { }
+
+        VariantCopyConstructor(VariantCopyConstructor&&) = default;
+        VariantCopyConstructor& 
+            operator=(VariantCopyConstructor const&) = default;
+        VariantCopyConstructor& operator=(VariantCopyConstructor&&) = default;
+    };
+
+    template<typename... Ts>
+    using VariantCopyConstructorBase = 
+        VariantCopyConstructor<
+            all_true<
+                !is_instrumented<Ts...>::value,
+                std::is_trivially_copy_constructible<Ts>::value...>::value,
+            Ts...>;
+
+    template<bool Trivial, typename... Ts>
+    struct VariantMoveConstructor;
+
+    template<typename... Ts>
+    struct VariantMoveConstructor<true, Ts...> 
+        : VariantCopyConstructorBase<Ts...> 
+    {
+        using VariantCopyConstructorBase<Ts...>::VariantCopyConstructorBase;
+    };
+
+    template<typename... Ts>
+    struct VariantMoveConstructor<false, Ts...> 
+        : VariantCopyConstructorBase<Ts...> 
+    {
+        using VariantCopyConstructorBase<Ts...>::VariantCopyConstructorBase;
+
+        VariantMoveConstructor(VariantMoveConstructor const&) = default;
+
+        VariantMoveConstructor(VariantMoveConstructor&& other)
             noexcept(all_noexcept_move_constructible<Ts...>::value)
+        :
+            VariantCopyConstructorBase<Ts...> { 
+                ConstructFrom { }, 
+                std::move(other) 
+            }
+        { }
+
+        VariantMoveConstructor& 
+            operator=(VariantMoveConstructor const&) = default;
+        VariantMoveConstructor& operator=(VariantMoveConstructor&&) = default;
+    };
+
+    template<typename... Ts>
+    using VariantMoveConstructorBase = 
+        VariantMoveConstructor<
+            all_true<
+                !is_instrumented<Ts...>::value,
+                std::is_trivially_move_constructible<Ts>::value...>::value,
+            Ts...>;
+
+    template<bool Trivial, typename... Ts>
+    struct VariantCopyAssign;
+
+    template<typename... Ts>
+    struct VariantCopyAssign<true, Ts...> 
+        : VariantMoveConstructorBase<Ts...> 
+    {
+        using VariantMoveConstructorBase<Ts...>::VariantMoveConstructorBase;
+    };
+
+    template<typename... Ts>
+    struct VariantCopyAssign<false, Ts...> 
+        : VariantMoveConstructorBase<Ts...> 
+    {
+        using VariantMoveConstructorBase<Ts...>::VariantMoveConstructorBase;
+
+        VariantCopyAssign(VariantCopyAssign const&) = default;
+        VariantCopyAssign(VariantCopyAssign&&) = default;
+
+        VariantCopyAssign& operator=(VariantCopyAssign const& other) 
+            noexcept(all_true<
+                is_nothrow_assignable_from<Ts, Ts const&>::value...>::value)
         {
-            this->~VariantStorage();
-            std::move(other).visit(
-                [this](auto&& val) {
-                    using T = typename std::decay<decltype(val)>::type;
-                    new (static_cast<void*>(get_storage())) T { 
-                        std::move(val) 
-                    };
-                    type_index_ = type_index_of<0, T, Ts...>::value;
-                }
-            );
+            this->assign_from(other);
+            return *this;
+        }
+
+        VariantCopyAssign& operator=(VariantCopyAssign&&) = default;
+    };
 
+    template<typename... Ts>
+    using VariantCopyAssignBase = 
+        VariantCopyAssign<
+            all_true<
+                !is_instrumented<Ts...>::value,
+                std::is_trivially_copy_constructible<Ts>::value...,
+                std::is_trivially_copy_assignable<Ts>::value...,
+                std::is_trivially_destructible<Ts>::value...>::value,
+            Ts...>;
+
+    template<bool Trivial, typename... Ts>
+    struct VariantMoveAssign;
+
+    template<typename... Ts>
+    struct VariantMoveAssign<true, Ts...> : VariantCopyAssignBase<Ts...> {
+        using VariantCopyAssignBase<Ts...>::VariantCopyAssignBase;
+    };
+
+    template<typename... Ts>
+    struct VariantMoveAssign<false, Ts...> : VariantCopyAssignBase<Ts...> {
+        using VariantCopyAssignBase<Ts...>::VariantCopyAssignBase;
+
+        VariantMoveAssign(VariantMoveAssign const&) = default;
+        VariantMoveAssign(VariantMoveAssign&&) = default;
+        VariantMoveAssign& operator=(VariantMoveAssign const&) = default;
+
+        VariantMoveAssign& operator=(VariantMoveAssign&& other) 
+            noexcept(all_true<
+                is_nothrow_assignable_from<Ts, Ts&&>::value...>::value)
+        {
+            this->assign_from(std::move(other));
             return *this;
         }
+    };
+
+    template<typename... Ts>
+    using VariantMoveAssignBase = 
+        VariantMoveAssign<
+            all_true<
+                !is_instrumented<Ts...>::value,
+                std::is_trivially_move_constructible<Ts>::value...,
+                std::is_trivially_move_assignable<Ts>::value...,
+                std::is_trivially_destructible<Ts>::value...>::value,
+            Ts...>;
+
+    template<typename... Ts>
+    struct VariantStorage : VariantMoveAssignBase<Ts...> {
+        template<
+            typename U,
+            typename std::enable_if<
+                !std::is_same<
+                    typename std::decay<U>::type,
+                    VariantStorage>::value &&
+                !is_in_place_tag<
+                    typename std::decay<U>::type>::value>::type* = nullptr>
+        constexpr VariantStorage(U&& val)
+            noexcept(
+                noexcept(stored_alternative_t<U, Ts...> { std::declval<U>() })
+            )
+        :
+            VariantMoveAssignBase<Ts...> { 
+                in_place_index<
+                    alternative_index_of<typename std::decay<U>::type, Ts...>::value>,
+                std::forward<U>(val)
+            }
+        { }
+
+        template<size_t I, typename... Args>
+        constexpr explicit VariantStorage(in_place_index_t<I>, 
+                                          Args&&... args)
+            noexcept(
+                std::is_nothrow_constructible<
+                    type_at_index_t<I, Ts...>, Args...>::value
+            )
+        :
+            VariantMoveAssignBase<Ts...> { 
+                in_place_index<I>, 
+                std::forward<Args>(args)... 
+            }
+        { }
+
+        template<typename T, typename... Args>
+        constexpr explicit VariantStorage(in_place_type_t<T>, 
+                                          Args&&... args)
+            noexcept(
+                std::is_nothrow_constructible<
+                    stored_alternative_t<T, Ts...>, Args...>::value
+            )
+        :
+            VariantStorage { 
+                in_place_index<alternative_index_of<T, Ts...>::value>,
+                std::forward<Args>(args)...
+            }
+        { }
 
         template<
             typename U,
@@ -249,130 +1727,48 @@ namespace variant {
                     VariantStorage>::value>::type* = nullptr>
         VariantStorage& operator=(U&& val)
             noexcept(
-                noexcept(typename std::decay<U>::type { std::declval<U>() })
+                is_nothrow_assignable_from<
+                    stored_alternative_t<U, Ts...>, U>::value
             )
         {
-            this->~VariantStorage();
-            type_index_ = 
-                type_index_of<0, typename std::decay<U>::type, Ts...>::value;
-            new (static_cast<void*>(get_storage())) typename std::decay<U>::type { 
-                std::forward<U>(val) 
-            };
+            constexpr auto I = 
+                alternative_index_of<typename std::decay<U>::type, Ts...>::value;
+            this->template assign<I>(
+                std::forward<U>(val), VariantEvent::Construct);
 
             return *this;
         }
 
-        template<typename T>
-        auto is_alternative() const -> bool {
-            return type_index_of<0, T, Ts...>::value == type_index_;
-        }
-
-        template<typename T>
-        auto get() & -> T& {
-            if (!is_alternative<T>()) {
-                throw IncorrectAlternativeError { };
-            }
-
-            return *reinterpret_cast<T*>(storage_);
-        }
-
-        template<typename T>
-        auto get() const & -> T const& {
-            return const_cast<VariantStorage&>(*this).get<T>();
-        }
-
-        template<typename T>
-        auto get() && -> T&& {
-            return std::move(get<T>());
-        }
-
-        template<size_t I>
-        auto get() & -> type_at_index_t<I, Ts...>& {
-            if (I != type_index_) {
-                throw IncorrectAlternativeError { };
-            }
-
-            using U = type_at_index_t<I, Ts...>;
-
-            return *reinterpret_cast<U*>(storage_);
-        }
-
-        template<size_t I>
-        auto get() const & 
-            -> type_at_index_t<I, Ts...> const& 
+        template<size_t I, typename... Args>
+        auto emplace(Args&&... args)
+            noexcept(
+                std::is_nothrow_constructible<
+                    type_at_index_t<I, Ts...>, Args...>::value
+            )
+            -> alternative_t<I, Ts...>&
         {
-            return const_cast<VariantStorage&>(*this).get<I>();
-        }
-
-        template<size_t I>
-        auto get() && -> type_at_index_t<I, Ts...>&& {
-            return std::move(get<I>());
-        }
-
-        template<typename F>
-        decltype(auto) visit(F&& visitor) const & {
-            using R = std::result_of_t<F(first_type_t<Ts...> const&)>;
-            using Fr = std::add_rvalue_reference_t<F>;
-            using Fn = R (*)(Fr, decltype(get_storage()));
-            Fn paths[sizeof...(Ts)] = {
-                apply_visitor<Ts const, Fr, decltype(get_storage())>...
-            };
-
-            return (paths[type_index_])(
-                std::forward<F>(visitor), 
-                get_storage());
-        }
-
-        template<typename F>
-        decltype(auto) visit(F&& visitor) & {
-            using R = std::result_of_t<F(first_type_t<Ts...>&)>;
-            using Fr = std::add_rvalue_reference_t<F>;
-            using Fn = R (*)(Fr, decltype(get_storage()));
-            Fn paths[sizeof...(Ts)] = {
-                apply_visitor<Ts, Fr, decltype(get_storage())>...
-            };
-
-            return (paths[type_index_])(
-                std::forward<F>(visitor), 
-                get_storage());
-        }
-
-        template<typename F>
-        decltype(auto) visit(F&& visitor) && {
-            using S = decltype(std::move(*this).get_storage());
-            using R = std::result_of_t<F(first_type_t<Ts...>&&)>;
-            using Fr = std::add_rvalue_reference_t<F>;
-            using Fn = auto (*)(Fr, S) -> R;
-            Fn paths[sizeof...(Ts)] = {
-                apply_move_visitor<Ts, Fr, S>...
-            };
-
-            return (paths[type_index_])(
-                std::forward<F>(visitor), 
-                std::move(*this).get_storage());
-        }
-
-    private:
-
-        using Storage = 
-            typename std::aligned_storage<max_size<Ts...>(),
-                                          max_align<Ts...>()>::type;
-
-        auto get_storage() const -> Storage const* {
-            return &storage_[0];
+            auto& val = this->template replace_in_place<I>(
+                std::forward<Args>(args)...);
+            record_event<Ts...>(VariantEvent::Construct, I);
+            return val;
         }
 
-        auto get_storage() -> Storage* {
-            return &storage_[0];
+        template<typename T, typename... Args>
+        auto emplace(Args&&... args)
+            noexcept(
+                std::is_nothrow_constructible<
+                    stored_alternative_t<T, Ts...>, Args...>::value
+            )
+            -> T&
+        {
+            return emplace<alternative_index_of<T, Ts...>::value>(
+                std::forward<Args>(args)...);
         }
-
-        size_t type_index_;
-        Storage storage_[1];
     };
 
     template<typename... Ts>
     struct Variant 
-        : std::conditional<all_copy_constructible<Ts...>::value, 
+        : std::conditional<all_copy_constructible<unboxed_t<Ts>...>::value, 
                            Copyable, 
                            NoCopyable>::type
     {
@@ -387,15 +1783,37 @@ namespace variant {
             typename std::enable_if<
                 !std::is_same<
                     typename std::decay<U>::type,
-                    Variant>::value>::type* = nullptr>
-        Variant(U&& val)
+                    Variant>::value &&
+                !is_in_place_tag<
+                    typename std::decay<U>::type>::value>::type* = nullptr>
+        constexpr Variant(U&& val)
             noexcept(
-                noexcept(typename std::decay<U>::type { std::declval<U>() })
+                noexcept(stored_alternative_t<U, Ts...> { std::declval<U>() })
             )
         :
             inner_ {std::forward<U>(val) }
         { }
 
+        template<size_t I, typename... Args>
+        constexpr explicit Variant(in_place_index_t<I> tag, Args&&... args)
+            noexcept(
+                std::is_nothrow_constructible<
+                    type_at_index_t<I, Ts...>, Args...>::value
+            )
+        :
+            inner_ { tag, std::forward<Args>(args)... }
+        { }
+
+        template<typename T, typename... Args>
+        constexpr explicit Variant(in_place_type_t<T> tag, Args&&... args)
+            noexcept(
+                std::is_nothrow_constructible<
+                    stored_alternative_t<T, Ts...>, Args...>::value
+            )
+        :
+            inner_ { tag, std::forward<Args>(args)... }
+        { }
+
         template<
             typename U,
             typename std::enable_if<
@@ -404,73 +1822,196 @@ namespace variant {
                     Variant>::value>::type* = nullptr>
         Variant& operator=(U&& val)
             noexcept(
-                noexcept(typename std::decay<U>::type { std::declval<U>() })
+                is_nothrow_assignable_from<
+                    stored_alternative_t<U, Ts...>, U>::value
             )
         {
-            inner_ = val;
+            inner_ = std::forward<U>(val);
             return *this;
         }
 
+        // Destroys the current value and constructs the new alternative 
+        // directly in place from `args`, with no temporary and no move. 
+        // The price is that if the constructor throws there is no value 
+        // to go back to, so it calls `std::terminate`, unless the 
+        // variant's `AssignStrategy` is `DoubleBuffer`.
+        template<typename T, typename... Args>
+        auto emplace(Args&&... args)
+            noexcept(
+                std::is_nothrow_constructible<
+                    stored_alternative_t<T, Ts...>, Args...>::value
+            )
+            -> T&
+        {
+            return inner_.template emplace<T>(std::forward<Args>(args)...);
+        }
+
+        template<size_t I, typename... Args>
+        auto emplace(Args&&... args)
+            noexcept(
+                std::is_nothrow_constructible<
+                    type_at_index_t<I, Ts...>, Args...>::value
+            )
+            -> alternative_t<I, Ts...>&
+        {
+            return inner_.template emplace<I>(std::forward<Args>(args)...);
+        }
+
         template<typename U>
-        auto is_alternative() const {
+        constexpr auto is_alternative() const {
             return inner_.template is_alternative<U>();
         }
 
+        constexpr auto index() const -> size_t {
+            return inner_.index();
+        }
+
         template<typename F>
-        auto visit(F&& visitor) & 
+        constexpr auto visit(F&& visitor) & 
             -> decltype(std::declval<VariantStorage<Ts...>&>().visit(std::forward<F>(visitor)))
         {
             return inner_.visit(std::forward<F>(visitor));
         }
 
         template<typename F>
-        auto visit(F&& visitor) const & 
+        constexpr auto visit(F&& visitor) const & 
             -> decltype(std::declval<VariantStorage<Ts...> const&>().visit(std::forward<F>(visitor)))
         {
             return inner_.visit(std::forward<F>(visitor));
         }
 
         template<typename F>
-        auto visit(F&& visitor) && 
+        constexpr auto visit(F&& visitor) && 
             -> decltype(std::declval<VariantStorage<Ts...>>().visit(std::forward<F>(visitor)))
         {
             return std::move(inner_).visit(std::forward<F>(visitor));
         }
 
+        // As `visit`, but tests for the alternatives at `Is` first. See 
+        // `VariantStorageBase::visit_hinted`.
+        template<size_t... Is, typename F>
+        constexpr decltype(auto) visit_hinted(F&& visitor) & {
+            return inner_.template visit_hinted<Is...>(
+                std::forward<F>(visitor));
+        }
+
+        template<size_t... Is, typename F>
+        constexpr decltype(auto) visit_hinted(F&& visitor) const & {
+            return inner_.template visit_hinted<Is...>(
+                std::forward<F>(visitor));
+        }
+
+        template<size_t... Is, typename F>
+        constexpr decltype(auto) visit_hinted(F&& visitor) && {
+            return std::move(inner_).template visit_hinted<Is...>(
+                std::forward<F>(visitor));
+        }
+
+        template<typename... Us, typename F>
+        constexpr decltype(auto) visit_likely(F&& visitor) & {
+            return inner_.template visit_likely<Us...>(
+                std::forward<F>(visitor));
+        }
+
+        template<typename... Us, typename F>
+        constexpr decltype(auto) visit_likely(F&& visitor) const & {
+            return inner_.template visit_likely<Us...>(
+                std::forward<F>(visitor));
+        }
+
+        template<typename... Us, typename F>
+        constexpr decltype(auto) visit_likely(F&& visitor) && {
+            return std::move(inner_).template visit_likely<Us...>(
+                std::forward<F>(visitor));
+        }
+
         template<typename T>
-        auto get() & -> T& {
+        constexpr auto get() & -> T& {
             return inner_.template get<T>();
         }
 
         template<typename T>
-        auto get() const & -> T const& {
+        constexpr auto get() const & -> T const& {
             return inner_.template get<T>();
         }
 
         template<typename T>
-        auto get() && -> T&& {
+        constexpr auto get() && -> T&& {
             return std::move(inner_).template get<T>();
         }
 
         template<size_t I>
-        decltype(auto) get() & {
+        constexpr decltype(auto) get() & {
             return inner_.template get<I>();
         }
 
         template<size_t I>
-        decltype(auto) get() const & {
+        constexpr decltype(auto) get() const & {
             return inner_.template get<I>();
         }
 
         template<size_t I>
-        decltype(auto) get() && {
+        constexpr decltype(auto) get() && {
             return std::move(inner_).template get<I>();
         }
 
+        template<typename T>
+        constexpr auto unsafe_get() & -> T& {
+            return inner_.template unsafe_get<T>();
+        }
+
+        template<typename T>
+        constexpr auto unsafe_get() const & -> T const& {
+            return inner_.template unsafe_get<T>();
+        }
+
+        template<typename T>
+        constexpr auto unsafe_get() && -> T&& {
+            return std::move(inner_).template unsafe_get<T>();
+        }
+
+        template<size_t I>
+        constexpr decltype(auto) unsafe_get() & {
+            return inner_.template unsafe_get<I>();
+        }
+
+        template<size_t I>
+        constexpr decltype(auto) unsafe_get() const & {
+            return inner_.template unsafe_get<I>();
+        }
+
+        template<size_t I>
+        constexpr decltype(auto) unsafe_get() && {
+            return std::move(inner_).template unsafe_get<I>();
+        }
+
     private:
+        friend struct VisitDispatcher;
+
+        template<size_t I>
+        constexpr decltype(auto) get_unchecked() & {
+            return VisitDispatcher::get<I>(inner_);
+        }
+
+        template<size_t I>
+        constexpr decltype(auto) get_unchecked() const & {
+            return VisitDispatcher::get<I>(inner_);
+        }
+
+        template<size_t I>
+        constexpr decltype(auto) get_unchecked() && {
+            return VisitDispatcher::get<I>(std::move(inner_));
+        }
+
         VariantStorage<Ts...> inner_;
     };
 
+    // A variant that boxes each alternative larger than `Limit` bytes, so
+    // that its size is bounded by `Limit` however large the rarer 
+    // alternatives are.
+    template<size_t Limit, typename... Ts>
+    using CompactVariant = Variant<box_if_larger_t<Limit, Ts>...>;
+
     namespace traits {
         template<typename T>
         struct is_variant : std::false_type { };
@@ -489,10 +2030,22 @@ namespace variant {
 
         template<typename T>
         constexpr bool is_variant_v = is_variant<T>::value;
+
+        template<typename T>
+        struct variant_size;
+
+        template<typename... Ts>
+        struct variant_size<Variant<Ts...>> 
+            : std::integral_constant<size_t, sizeof...(Ts)> 
+        { };
+
+        template<typename T>
+        constexpr size_t variant_size_v = 
+            variant_size<std::decay_t<T>>::value;
     }
 
     template<typename T, typename... Ts>
-    auto is_alternative(Variant<Ts...> const& v) -> bool {
+    constexpr auto is_alternative(Variant<Ts...> const& v) -> bool {
         return v.template is_alternative<T>();
     }
 
@@ -500,15 +2053,94 @@ namespace variant {
         typename F, 
         typename V,
         typename std::enable_if<traits::is_variant_v<V>>::type* = nullptr>
-    decltype(auto) visit(F&& visitor, V&& var) {
+    constexpr decltype(auto) visit(F&& visitor, V&& var) {
         return std::forward<V>(var).visit(std::forward<F>(visitor));
     }
 
+    template<
+        size_t... Is,
+        typename F, 
+        typename V,
+        typename std::enable_if<traits::is_variant_v<V>>::type* = nullptr>
+    constexpr decltype(auto) visit_hinted(F&& visitor, V&& var) {
+        return std::forward<V>(var).template visit_hinted<Is...>(
+            std::forward<F>(visitor));
+    }
+
+    template<
+        typename... Us,
+        typename F, 
+        typename V,
+        typename std::enable_if<traits::is_variant_v<V>>::type* = nullptr>
+    constexpr decltype(auto) visit_likely(F&& visitor, V&& var) {
+        return std::forward<V>(var).template visit_likely<Us...>(
+            std::forward<F>(visitor));
+    }
+
+    template<typename... Vs>
+    constexpr auto flatten_index(Vs const&... vs) -> size_t {
+        size_t const sizes[] = { traits::variant_size_v<Vs>... };
+        size_t const indices[] = { vs.index()... };
+        size_t flat = 0;
+        for (size_t i = 0; i < sizeof...(Vs); ++i) {
+            flat = flat * sizes[i] + indices[i];
+        }
+
+        return flat;
+    }
+
+    template<typename... Ts>
+    constexpr auto record_visit(Variant<Ts...> const& v) -> void {
+        record_event<Ts...>(VariantEvent::Visit, v.index());
+    }
+
+    template<typename... Vs>
+    constexpr auto record_visits(Vs const&... vs) -> void {
+        using expand = int[];
+        (void)expand { 0, (record_visit(vs), 0)... };
+    }
+
+    // Visits several variants with a single dispatch on their combined
+    // index, rather than one nested visit per variant. The visitor
+    // receives one alternative from each variant, with the value category 
+    // of the variant it came from.
+    template<
+        typename F,
+        typename V,
+        typename W,
+        typename... Vs,
+        typename std::enable_if<
+            all_true<traits::is_variant_v<V>,
+                     traits::is_variant_v<W>,
+                     traits::is_variant_v<Vs>...>::value>::type* = nullptr>
+    constexpr decltype(auto) visit(F&& visitor, V&& v, W&& w, Vs&&... vs) {
+        using R = std::result_of_t<
+            F(decltype(VisitDispatcher::get<0>(std::declval<V>())),
+              decltype(VisitDispatcher::get<0>(std::declval<W>())),
+              decltype(VisitDispatcher::get<0>(std::declval<Vs>()))...)>;
+
+        using Sizes = std::index_sequence<
+            traits::variant_size_v<V>,
+            traits::variant_size_v<W>,
+            traits::variant_size_v<Vs>...>;
+
+        record_visits(v, w, vs...);
+        return dispatch<MultiVisit<R, F, Sizes, V, W, Vs...>,
+                        product<traits::variant_size_v<V>,
+                                traits::variant_size_v<W>,
+                                traits::variant_size_v<Vs>...>()>(
+            flatten_index(v, w, vs...),
+            std::forward<F>(visitor),
+            std::forward<V>(v),
+            std::forward<W>(w),
+            std::forward<Vs>(vs)...);
+    }
+
     template<
         typename T, 
         typename V,
         typename std::enable_if<traits::is_variant_v<V>>::type* = nullptr>
-    decltype(auto) get(V&& var) {
+    constexpr decltype(auto) get(V&& var) {
         return std::forward<V>(var).template get<T>();
     }
 
@@ -516,8 +2148,256 @@ namespace variant {
         size_t I,
         typename V,
         typename std::enable_if<traits::is_variant_v<V>>::type* = nullptr>
-    decltype(auto) get(V&& val) {
+    constexpr decltype(auto) get(V&& val) {
         return std::forward<V>(val).template get<I>();
     }
+
+    template<
+        typename T, 
+        typename V,
+        typename std::enable_if<traits::is_variant_v<V>>::type* = nullptr>
+    constexpr decltype(auto) unsafe_get(V&& var) {
+        return std::forward<V>(var).template unsafe_get<T>();
+    }
+
+    template<
+        size_t I,
+        typename V,
+        typename std::enable_if<traits::is_variant_v<V>>::type* = nullptr>
+    constexpr decltype(auto) unsafe_get(V&& var) {
+        return std::forward<V>(var).template unsafe_get<I>();
+    }
+
+    // Returns a pointer to the held `T`, or null if `var` is null or holds 
+    // another alternative. Never throws.
+    template<typename T, typename... Ts>
+    auto get_if(Variant<Ts...>* var) noexcept -> T* {
+        if (!var || !var->template is_alternative<T>()) {
+            return nullptr;
+        }
+
+        return &var->template unsafe_get<T>();
+    }
+
+    template<typename T, typename... Ts>
+    auto get_if(Variant<Ts...> const* var) noexcept -> T const* {
+        return get_if<T>(const_cast<Variant<Ts...>*>(var));
+    }
+
+    template<size_t I, typename... Ts>
+    auto get_if(Variant<Ts...>* var) noexcept 
+        -> alternative_t<I, Ts...>* 
+    {
+        if (!var || var->index() != I) {
+            return nullptr;
+        }
+
+        return &var->template unsafe_get<I>();
+    }
+
+    template<size_t I, typename... Ts>
+    auto get_if(Variant<Ts...> const* var) noexcept 
+        -> alternative_t<I, Ts...> const* 
+    {
+        return get_if<I>(const_cast<Variant<Ts...>*>(var));
+    }
+
+    template<typename T>
+    auto payload_bytes(T const& v) -> unsigned char const* {
+        return reinterpret_cast<unsigned char const*>(
+            &VisitDispatcher::get<0>(v));
+    }
+
+    // Applies `Op` to the alternative of `lhs` and the same alternative of 
+    // `other`, which the caller has checked is active.
+    template<typename Op, typename V>
+    struct CompareAlternative {
+        template<size_t K, typename T>
+        auto operator()(std::integral_constant<size_t, K>, T const& lhs) const 
+            -> bool 
+        {
+            return Op { }(lhs, VisitDispatcher::get<K>(other));
+        }
+
+        V const& other;
+    };
+
+    struct HashAlternative {
+        template<size_t K, typename T>
+        auto operator()(std::integral_constant<size_t, K>, T const& val) const 
+            -> size_t 
+        {
+            return std::hash<T> { }(val);
+        }
+    };
+
+    template<typename Op, typename... Ts>
+    auto compare_active(Variant<Ts...> const& lhs, Variant<Ts...> const& rhs) 
+        -> bool 
+    {
+        using V = Variant<Ts...>;
+        using F = CompareAlternative<Op, V>;
+        return dispatch<IndexedVisit<bool, F, V const&>, sizeof...(Ts)>(
+            lhs.index(), F { rhs }, lhs);
+    }
+
+    // The whole payload of a `has_word_payload` variant, including the 
+    // zeroed bytes the active alternative doesn't use.
+    template<typename... Ts>
+    auto load_payload(Variant<Ts...> const& v) -> std::uint64_t {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, payload_bytes(v), max_size<Ts...>());
+        return bits;
+    }
+
+    // How a variant's payloads can be compared and hashed: `Dispatch` 
+    // goes through the alternatives' own operators, `Bytes` compares the
+    // active alternative's bytes and `Word` does the same through a single
+    // integer load.
+    enum class PayloadKind { Dispatch, Bytes, Word };
+
+    template<typename... Ts>
+    using payload_kind = std::integral_constant<
+        PayloadKind,
+        has_word_payload<Ts...>::value 
+            ? PayloadKind::Word
+            : all_true<is_bytewise_comparable<Ts>::value...>::value
+                ? PayloadKind::Bytes 
+                : PayloadKind::Dispatch>;
+
+    template<typename... Ts>
+    auto equal_payloads(
+        Variant<Ts...> const& lhs, 
+        Variant<Ts...> const& rhs, 
+        std::integral_constant<PayloadKind, PayloadKind::Word>) 
+        -> bool 
+    {
+        return load_payload(lhs) == load_payload(rhs);
+    }
+
+    template<typename... Ts>
+    auto equal_payloads(
+        Variant<Ts...> const& lhs, 
+        Variant<Ts...> const& rhs, 
+        std::integral_constant<PayloadKind, PayloadKind::Bytes>) 
+        -> bool 
+    {
+        constexpr size_t sizes[] = { sizeof(Ts)... };
+        return std::memcmp(
+            payload_bytes(lhs), 
+            payload_bytes(rhs), 
+            sizes[lhs.index()]) == 0;
+    }
+
+    template<typename... Ts>
+    auto equal_payloads(
+        Variant<Ts...> const& lhs, 
+        Variant<Ts...> const& rhs, 
+        std::integral_constant<PayloadKind, PayloadKind::Dispatch>) 
+        -> bool 
+    {
+        return compare_active<std::equal_to<>>(lhs, rhs);
+    }
+
+    inline auto hash_combine(size_t seed, size_t h) -> size_t {
+        return seed ^ (h + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+    // Word sized payloads are mixed with the final step of SplitMix64 
+    // rather than hashed per alternative.
+    template<typename... Ts>
+    auto hash_payload(
+        Variant<Ts...> const& v, 
+        std::integral_constant<PayloadKind, PayloadKind::Word>) 
+        -> size_t 
+    {
+        auto bits = load_payload(v);
+        bits ^= bits >> 30;
+        bits *= 0xbf58476d1ce4e5b9ull;
+        bits ^= bits >> 27;
+        bits *= 0x94d049bb133111ebull;
+        bits ^= bits >> 31;
+        return static_cast<size_t>(bits);
+    }
+
+    template<PayloadKind Kind, typename... Ts>
+    auto hash_payload(Variant<Ts...> const& v, 
+                      std::integral_constant<PayloadKind, Kind>) 
+        -> size_t 
+    {
+        using V = Variant<Ts...>;
+        return dispatch<IndexedVisit<size_t, HashAlternative, V const&>, 
+                        sizeof...(Ts)>(
+            v.index(), HashAlternative { }, v);
+    }
+
+    // Equal when both hold the same alternative with equal values. The 
+    // values are compared with one dispatch on the shared index, or by 
+    // their bytes when every alternative is bytewise comparable.
+    template<typename... Ts>
+    auto operator==(Variant<Ts...> const& lhs, Variant<Ts...> const& rhs) 
+        -> bool 
+    {
+        return lhs.index() == rhs.index() &&
+            equal_payloads(lhs, rhs, payload_kind<Ts...> { });
+    }
+
+    template<typename... Ts>
+    auto operator!=(Variant<Ts...> const& lhs, Variant<Ts...> const& rhs) 
+        -> bool 
+    {
+        return !(lhs == rhs);
+    }
+
+    // Orders by alternative index first, then by value.
+    template<typename... Ts>
+    auto operator<(Variant<Ts...> const& lhs, Variant<Ts...> const& rhs) 
+        -> bool 
+    {
+        if (lhs.index() != rhs.index()) {
+            return lhs.index() < rhs.index();
+        }
+
+        return compare_active<std::less<>>(lhs, rhs);
+    }
+
+    template<typename... Ts>
+    auto operator>(Variant<Ts...> const& lhs, Variant<Ts...> const& rhs) 
+        -> bool 
+    {
+        return rhs < lhs;
+    }
+
+    template<typename... Ts>
+    auto operator<=(Variant<Ts...> const& lhs, Variant<Ts...> const& rhs) 
+        -> bool 
+    {
+        return !(rhs < lhs);
+    }
+
+    template<typename... Ts>
+    auto operator>=(Variant<Ts...> const& lhs, Variant<Ts...> const& rhs) 
+        -> bool 
+    {
+        return !(lhs < rhs);
+    }
+
+    // The alternative's index is mixed in so that equal values held as 
+    // different alternatives don't collide.
+    template<typename... Ts>
+    auto hash_value(Variant<Ts...> const& v) -> size_t {
+        return hash_combine(
+            hash_payload(v, payload_kind<Ts...> { }), 
+            v.index());
+    }
+}
+
+namespace std {
+    template<typename... Ts>
+    struct hash<variant::Variant<Ts...>> {
+        auto operator()(variant::Variant<Ts...> const& v) const -> size_t {
+            return variant::hash_value(v);
+        }
+    };
 }
 #endif //VARIANT_VARIANT_HPP_INCLUDED
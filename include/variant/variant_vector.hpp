@@ -0,0 +1,289 @@
+#ifndef VARIANT_VARIANT_VECTOR_HPP_INCLUDED
+#define VARIANT_VARIANT_VECTOR_HPP_INCLUDED
+
+#include "variant/variant.hpp"
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifdef VARIANT_NO_EXCEPTIONS
+#include <cstdlib>
+#endif
+
+namespace variant {
+
+    [[noreturn]] inline auto variant_vector_pool_full() -> void {
+#ifdef VARIANT_NO_EXCEPTIONS
+        assert(!"VariantVector pool is full");
+        std::abort();
+#else
+        throw std::length_error { "VariantVector pool is full" };
+#endif
+    }
+
+    // A sequence of heterogeneous values stored as a structure of arrays: 
+    // a compact tag per element, plus one dense pool per alternative. 
+    // Elements only take up the space of their own alternative, and 
+    // `visit_all` walks each pool contiguously with no per-element 
+    // dispatch.
+    template<typename... Ts>
+    struct VariantVector {
+        static_assert(0 < sizeof...(Ts),
+            "VariantVector must hold at least one type");
+
+        // `std::vector<bool>` hands out proxies rather than references.
+        static_assert(all_true<!std::is_same<Ts, bool>::value...>::value,
+            "VariantVector can't hold bool; wrap it in a struct");
+
+        using tag_type = index_type_t<sizeof...(Ts)>;
+
+        // Each element's position within its pool, so a single pool holds
+        // at most 2^32 - 1 elements. Adding another throws 
+        // `std::length_error`, or aborts without exceptions.
+        using offset_type = std::uint32_t;
+
+        // A reference to a single element, offering the same access as 
+        // `Variant`. Invalidated by anything that would invalidate an
+        // iterator into one of the pools.
+        template<typename V>
+        struct BasicReference {
+            auto index() const -> size_t {
+                return vec_->tags_[pos_];
+            }
+
+            template<typename T>
+            auto is_alternative() const -> bool {
+                return type_index_of<0, T, Ts...>::value == index();
+            }
+
+            template<size_t I>
+            decltype(auto) get() const {
+                if (I != index()) {
+                    incorrect_alternative();
+                }
+
+                return get_unchecked<I>();
+            }
+
+            template<typename T>
+            decltype(auto) get() const {
+                return get<type_index_of<0, T, Ts...>::value>();
+            }
+
+            template<size_t I>
+            decltype(auto) unsafe_get() const {
+                assert(I == index());
+                return get_unchecked<I>();
+            }
+
+            template<typename T>
+            decltype(auto) unsafe_get() const {
+                return unsafe_get<type_index_of<0, T, Ts...>::value>();
+            }
+
+            template<typename F>
+            decltype(auto) visit(F&& visitor) const {
+                using R = std::result_of_t<
+                    F(decltype(get_unchecked<0>()))>;
+                return dispatch<SingleVisit<R, F, BasicReference const&>,
+                                sizeof...(Ts)>(
+                    index(),
+                    std::forward<F>(visitor),
+                    *this);
+            }
+
+        private:
+            friend struct VariantVector;
+            friend struct VisitDispatcher;
+
+            BasicReference(V* vec, size_t pos) :
+                vec_ { vec },
+                pos_ { pos }
+            { }
+
+            template<size_t I>
+            decltype(auto) get_unchecked() const {
+                return std::get<I>(vec_->pools_)[vec_->offsets_[pos_]];
+            }
+
+            V* vec_;
+            size_t pos_;
+        };
+
+        using Reference = BasicReference<VariantVector>;
+        using ConstReference = BasicReference<VariantVector const>;
+
+        template<
+            typename U,
+            typename std::enable_if<
+                !traits::is_variant_v<U>>::type* = nullptr>
+        auto push_back(U&& val) -> void {
+            emplace_back<typename std::decay<U>::type>(std::forward<U>(val));
+        }
+
+        // Appends whichever alternative `var` holds. Each of its 
+        // alternatives must also be one of `Ts`.
+        template<
+            typename V,
+            typename std::enable_if<
+                traits::is_variant_v<V>>::type* = nullptr>
+        auto push_back(V&& var) -> void {
+            std::forward<V>(var).visit(
+                [this](auto&& alt) { 
+                    push_back(std::forward<decltype(alt)>(alt)); 
+                }
+            );
+        }
+
+        template<size_t I, typename... Args>
+        auto emplace_back(Args&&... args) -> type_at_index_t<I, Ts...>& {
+            auto& pool = std::get<I>(pools_);
+            if (pool.size() >= std::numeric_limits<offset_type>::max()) {
+                variant_vector_pool_full();
+            }
+
+            tags_.push_back(static_cast<tag_type>(I));
+#ifndef VARIANT_NO_EXCEPTIONS
+            try {
+                offsets_.push_back(static_cast<offset_type>(pool.size()));
+                construct_back(pool, std::forward<Args>(args)...);
+            }
+            catch (...) {
+                offsets_.resize(tags_.size() - 1);
+                tags_.pop_back();
+                throw;
+            }
+#else
+            offsets_.push_back(static_cast<offset_type>(pool.size()));
+            construct_back(pool, std::forward<Args>(args)...);
+#endif
+
+            return pool.back();
+        }
+
+        template<typename T, typename... Args>
+        auto emplace_back(Args&&... args) -> T& {
+            return emplace_back<type_index_of<0, T, Ts...>::value>(
+                std::forward<Args>(args)...);
+        }
+
+        auto operator[](size_t pos) -> Reference {
+            assert(pos < size());
+            return Reference { this, pos };
+        }
+
+        auto operator[](size_t pos) const -> ConstReference {
+            assert(pos < size());
+            return ConstReference { this, pos };
+        }
+
+        auto size() const -> size_t {
+            return tags_.size();
+        }
+
+        auto empty() const -> bool {
+            return tags_.empty();
+        }
+
+        // Makes room for `count` elements in total without reallocating 
+        // the tags or offsets. Each pool still grows as it needs to.
+        auto reserve(size_t count) -> void {
+            tags_.reserve(count);
+            offsets_.reserve(count);
+        }
+
+        auto clear() -> void {
+            tags_.clear();
+            offsets_.clear();
+            clear_pools(std::index_sequence_for<Ts...> { });
+        }
+
+        // The dense pool holding every element of alternative `I`, in the
+        // order they were added.
+        template<size_t I>
+        auto pool() const -> std::vector<type_at_index_t<I, Ts...>> const& {
+            return std::get<I>(pools_);
+        }
+
+        template<typename T>
+        auto pool() const -> std::vector<T> const& {
+            return pool<type_index_of<0, T, Ts...>::value>();
+        }
+
+        // Calls `visitor` on every element, one alternative at a time. 
+        // Elements of the same alternative are visited in the order they 
+        // were added, but not interleaved with other alternatives.
+        template<typename F>
+        auto visit_all(F&& visitor) -> void {
+            visit_pools(visitor, pools_, std::index_sequence_for<Ts...> { });
+        }
+
+        template<typename F>
+        auto visit_all(F&& visitor) const -> void {
+            visit_pools(visitor, pools_, std::index_sequence_for<Ts...> { });
+        }
+
+    private:
+        template<typename T, typename... Args>
+        static auto construct_back(std::vector<T>& pool, Args&&... args) 
+            -> void 
+        {
+            construct_back(
+                pool, 
+                std::integral_constant<
+                    bool, 
+                    std::is_constructible<T, Args...>::value> { },
+                std::forward<Args>(args)...);
+        }
+
+        template<typename T, typename... Args>
+        static auto construct_back(std::vector<T>& pool, 
+                                   std::true_type, 
+                                   Args&&... args) 
+            -> void 
+        {
+            pool.emplace_back(std::forward<Args>(args)...);
+        }
+
+        template<typename T, typename... Args>
+        static auto construct_back(std::vector<T>& pool, 
+                                   std::false_type, 
+                                   Args&&... args) 
+            -> void 
+        {
+            pool.push_back(T { std::forward<Args>(args)... });
+        }
+
+        template<size_t... Is>
+        auto clear_pools(std::index_sequence<Is...>) -> void {
+            int expand[] = { (std::get<Is>(pools_).clear(), 0)... };
+            (void)expand;
+        }
+
+        template<typename F, typename Pools, size_t... Is>
+        static auto visit_pools(F& visitor, 
+                                Pools& pools, 
+                                std::index_sequence<Is...>) 
+            -> void 
+        {
+            int expand[] = { (visit_pool(visitor, std::get<Is>(pools)), 0)... };
+            (void)expand;
+        }
+
+        template<typename F, typename Pool>
+        static auto visit_pool(F& visitor, Pool& pool) -> void {
+            for (auto& val : pool) {
+                visitor(val);
+            }
+        }
+
+        std::vector<tag_type> tags_;
+        std::vector<offset_type> offsets_;
+        std::tuple<std::vector<Ts>...> pools_;
+    };
+}
+#endif //VARIANT_VARIANT_VECTOR_HPP_INCLUDED
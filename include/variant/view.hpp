@@ -0,0 +1,325 @@
+#ifndef VARIANT_VIEW_HPP_INCLUDED
+#define VARIANT_VIEW_HPP_INCLUDED
+
+#include "variant/variant.hpp"
+#include "variant/serialize.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace variant {
+
+    // A read-only variant whose payload lives in memory it doesn't own,
+    // such as a serialized record in a mapped file. It offers the const
+    // part of `Variant`'s interface; alternatives are handed out as
+    // references into that memory, which must outlive the view and be
+    // suitably aligned.
+    template<typename... Ts>
+    struct VariantView {
+        static_assert(
+            all_true<is_trivially_serializable<Ts>::value...>::value,
+            "VariantView alternatives must all be trivially serializable");
+
+        VariantView(size_t index, void const* payload) :
+            payload_ { static_cast<unsigned char const*>(payload) },
+            type_index_ { index }
+        {
+            assert(index < sizeof...(Ts));
+        }
+
+        auto index() const -> size_t {
+            return type_index_;
+        }
+
+        // The address of the payload in the underlying memory.
+        auto data() const -> void const* {
+            return payload_;
+        }
+
+        template<typename T>
+        auto is_alternative() const -> bool {
+            return alternative_index_of<T, Ts...>::value == type_index_;
+        }
+
+        template<size_t I>
+        auto get() const -> alternative_t<I, Ts...> const& {
+            if (type_index_ != I) {
+                incorrect_alternative();
+            }
+
+            return unsafe_get<I>();
+        }
+
+        template<typename T>
+        auto get() const -> T const& {
+            return get<alternative_index_of<T, Ts...>::value>();
+        }
+
+        template<size_t I>
+        auto unsafe_get() const -> alternative_t<I, Ts...> const& {
+            return get_unchecked<I>();
+        }
+
+        template<typename T>
+        auto unsafe_get() const -> T const& {
+            return unsafe_get<alternative_index_of<T, Ts...>::value>();
+        }
+
+        template<typename F>
+        decltype(auto) visit(F&& visitor) const {
+            using R = std::result_of_t<F(first_type_t<Ts...> const&)>;
+            return dispatch<SingleVisit<R, F, VariantView const&>,
+                            sizeof...(Ts)>(
+                type_index_,
+                std::forward<F>(visitor),
+                *this);
+        }
+
+    private:
+        friend struct VisitDispatcher;
+
+        template<size_t I>
+        auto get_unchecked() const -> alternative_t<I, Ts...> const& {
+            return *reinterpret_cast<alternative_t<I, Ts...> const*>(
+                payload_);
+        }
+
+        unsigned char const* payload_;
+        size_t type_index_;
+    };
+
+    template<typename V>
+    struct view_of;
+
+    template<typename... Ts>
+    struct view_of<Variant<Ts...>> {
+        using type = VariantView<Ts...>;
+    };
+
+    // The view type for records written from a `V`.
+    template<typename V>
+    using view_of_t = typename view_of<V>::type;
+
+    template<typename T, typename... Ts>
+    auto is_alternative(VariantView<Ts...> const& v) -> bool {
+        return v.template is_alternative<T>();
+    }
+
+    template<typename T, typename... Ts>
+    auto get(VariantView<Ts...> const& v) -> T const& {
+        return v.template get<T>();
+    }
+
+    template<size_t I, typename... Ts>
+    auto get(VariantView<Ts...> const& v) -> alternative_t<I, Ts...> const& {
+        return v.template get<I>();
+    }
+
+    template<typename T, typename... Ts>
+    auto unsafe_get(VariantView<Ts...> const& v) -> T const& {
+        return v.template unsafe_get<T>();
+    }
+
+    template<size_t I, typename... Ts>
+    auto unsafe_get(VariantView<Ts...> const& v)
+        -> alternative_t<I, Ts...> const&
+    {
+        return v.template unsafe_get<I>();
+    }
+
+    template<typename F, typename... Ts>
+    decltype(auto) visit(F&& visitor, VariantView<Ts...> const& v) {
+        return v.visit(std::forward<F>(visitor));
+    }
+
+    // How records follow one another in a stream. `Packed` records are
+    // exactly what `serialize` writes, back to back; the index says how
+    // long each one is. `LengthPrefixed` records are each preceded by
+    // a `std::uint32_t` count of the bytes that follow it, as written by
+    // `serialize_prefixed`.
+    enum class RecordFraming { Packed, LengthPrefixed };
+
+    // Appends `v` to `w` preceded by its length in bytes.
+    template<typename... Ts>
+    auto serialize_prefixed(BinaryWriter& w, Variant<Ts...> const& v)
+        -> void
+    {
+        std::uint32_t length = 0;
+        w.write(length);
+        auto const length_at = w.size() - sizeof(length);
+        w.write(v);
+        length = static_cast<std::uint32_t>(
+            w.size() - length_at - sizeof(length));
+        w.overwrite(length_at, &length, sizeof(length));
+    }
+
+    // Steps through a stream of serialized `Variant<Ts...>` records,
+    // yielding a `VariantView` of each without copying its payload.
+    // Records are checked as they're reached, so a corrupt or truncated
+    // stream is reported as a `DeserializationError` rather than read
+    // past.
+    template<RecordFraming Framing, typename... Ts>
+    struct RecordIterator {
+        using iterator_category = std::input_iterator_tag;
+        using value_type = VariantView<Ts...>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = VariantView<Ts...> const*;
+        using reference = VariantView<Ts...>;
+
+        RecordIterator(unsigned char const* data, size_t size, size_t pos) :
+            data_ { data },
+            size_ { size },
+            position_ { pos },
+            next_ { pos },
+            current_ { 0, data }
+        {
+            decode();
+        }
+
+        auto operator*() const -> reference {
+            return current_;
+        }
+
+        auto operator->() const -> pointer {
+            return &current_;
+        }
+
+        auto operator++() -> RecordIterator& {
+            position_ = next_;
+            decode();
+            return *this;
+        }
+
+        auto operator++(int) -> RecordIterator {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        // The offset of the current record within the stream.
+        auto position() const -> size_t {
+            return position_;
+        }
+
+        friend auto operator==(RecordIterator const& lhs,
+                               RecordIterator const& rhs) -> bool
+        {
+            return lhs.position_ == rhs.position_;
+        }
+
+        friend auto operator!=(RecordIterator const& lhs,
+                               RecordIterator const& rhs) -> bool
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        using Index = index_type_t<sizeof...(Ts)>;
+
+        // Alignments are powers of two, so this needs no division.
+        static auto align_up(size_t pos, size_t align) -> size_t {
+            return (pos + align - 1) & ~(align - 1);
+        }
+
+        // Checks that [pos, pos + n) lies within `limit`.
+        static auto check(size_t pos, size_t n, size_t limit) -> void {
+            if (pos > limit || n > limit - pos) {
+                corrupt_input("Record stream is truncated");
+            }
+        }
+
+        // Finds the record at `position_`, leaving `next_` at the one
+        // after it.
+        auto decode() -> void {
+            if (position_ == size_) {
+                return;
+            }
+
+            auto limit = size_;
+            auto pos = position_;
+            if (Framing == RecordFraming::LengthPrefixed) {
+                pos = align_up(pos, alignof(std::uint32_t));
+                check(pos, sizeof(std::uint32_t), size_);
+                std::uint32_t length;
+                std::memcpy(&length, data_ + pos, sizeof(length));
+                pos += sizeof(length);
+                check(pos, length, size_);
+                limit = pos + length;
+            }
+
+            pos = align_up(pos, alignof(Index));
+            check(pos, sizeof(Index), limit);
+            Index index;
+            std::memcpy(&index, data_ + pos, sizeof(index));
+            if (index >= sizeof...(Ts)) {
+                corrupt_input("Record has an invalid index");
+            }
+
+            constexpr size_t sizes[] = { sizeof(Ts)... };
+            constexpr size_t aligns[] = { alignof(Ts)... };
+            pos = align_up(pos + sizeof(Index), aligns[index]);
+            check(pos, sizes[index], limit);
+
+            current_ = VariantView<Ts...> { index, data_ + pos };
+            next_ = Framing == RecordFraming::LengthPrefixed
+                ? limit
+                : pos + sizes[index];
+        }
+
+        unsigned char const* data_;
+        size_t size_;
+        size_t position_;
+        size_t next_;
+        VariantView<Ts...> current_;
+    };
+
+    template<RecordFraming Framing, typename V>
+    struct RecordRange;
+
+    // The records in a byte range, for use with range-based `for`. The
+    // range must start where the writer started, and be aligned for every
+    // alternative.
+    template<RecordFraming Framing, typename... Ts>
+    struct RecordRange<Framing, Variant<Ts...>> {
+        using iterator = RecordIterator<Framing, Ts...>;
+
+        RecordRange(void const* data, size_t size) :
+            data_ { static_cast<unsigned char const*>(data) },
+            size_ { size }
+        {
+            assert((reinterpret_cast<std::uintptr_t>(data) %
+                max_align<Ts..., std::uint32_t>() == 0));
+        }
+
+        auto begin() const -> iterator {
+            return iterator { data_, size_, 0 };
+        }
+
+        auto end() const -> iterator {
+            return iterator { data_, size_, size_ };
+        }
+
+    private:
+        unsigned char const* data_;
+        size_t size_;
+    };
+
+    template<typename V>
+    auto records(void const* data, size_t size)
+        -> RecordRange<RecordFraming::Packed, V>
+    {
+        return { data, size };
+    }
+
+    template<typename V>
+    auto prefixed_records(void const* data, size_t size)
+        -> RecordRange<RecordFraming::LengthPrefixed, V>
+    {
+        return { data, size };
+    }
+}
+
+#endif //VARIANT_VIEW_HPP_INCLUDED
@@ -0,0 +1,131 @@
+#ifndef VARIANT_VISIT_EACH_HPP_INCLUDED
+#define VARIANT_VISIT_EACH_HPP_INCLUDED
+
+#include "variant/variant.hpp"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <vector>
+
+namespace variant {
+
+    struct preserve_order_t { };
+
+    constexpr preserve_order_t preserve_order { };
+
+    // Visits a run [first, last) of elements that all hold alternative 
+    // `K`, so no per-element dispatch is needed.
+    template<typename F, typename It>
+    struct RunVisit {
+        using Fn = auto (*)(F&, It const&, It const&) -> void;
+
+        template<size_t K>
+        static auto call(F& f, It const& first, It const& last) -> void {
+            for (auto it = first; it != last; ++it) {
+                f((*it).template unsafe_get<K>());
+            }
+        }
+    };
+
+    // Visits the elements of `buckets` that hold alternative `K`, i.e. 
+    // those between `offsets[K]` and `offsets[K + 1]`.
+    template<typename F, typename It, size_t M, size_t K>
+    auto visit_bucket(F& visitor, 
+                      std::vector<It> const& buckets, 
+                      std::array<size_t, M> const& offsets) 
+        -> void 
+    {
+        for (auto i = offsets[K]; i < offsets[K + 1]; ++i) {
+            visitor((*buckets[i]).template unsafe_get<K>());
+        }
+    }
+
+    template<typename F, typename It, size_t M, size_t... Ks>
+    auto visit_buckets(F& visitor, 
+                       std::vector<It> const& buckets, 
+                       std::array<size_t, M> const& offsets,
+                       std::index_sequence<Ks...>) 
+        -> void 
+    {
+        int expand[] = { 
+            (visit_bucket<F, It, M, Ks>(visitor, buckets, offsets), 0)... 
+        };
+        (void)expand;
+    }
+
+    template<typename It>
+    using iterator_variant_t = 
+        typename std::iterator_traits<It>::value_type;
+
+    // Calls `visitor` on every element of [first, last), one alternative 
+    // at a time: elements are bucketed by alternative into an iterator 
+    // permutation, then each bucket is walked with the alternative known 
+    // up front. Within a bucket, elements are visited in range order.
+    template<typename It, typename F>
+    auto visit_each(It first, It last, F&& visitor) -> void {
+        constexpr size_t N = traits::variant_size_v<iterator_variant_t<It>>;
+
+        std::array<size_t, N + 1> offsets { };
+        for (auto it = first; it != last; ++it) {
+            ++offsets[(*it).index() + 1];
+        }
+
+        for (size_t i = 1; i < offsets.size(); ++i) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        std::vector<It> buckets(offsets[N]);
+        auto positions = offsets;
+        for (auto it = first; it != last; ++it) {
+            buckets[positions[(*it).index()]++] = it;
+        }
+
+        visit_buckets(
+            visitor, 
+            buckets, 
+            offsets, 
+            std::make_index_sequence<N> { });
+    }
+
+    // As `visit_each`, but elements are visited in range order. The 
+    // visitor is dispatched once per run of consecutive elements holding 
+    // the same alternative, rather than once per element, so ranges that 
+    // are sorted or clustered by alternative visit almost dispatch-free.
+    template<typename It, typename F>
+    auto visit_each(It first, It last, F&& visitor, preserve_order_t) 
+        -> void 
+    {
+        constexpr size_t N = traits::variant_size_v<iterator_variant_t<It>>;
+
+        while (first != last) {
+            auto const index = (*first).index();
+            auto run_end = std::next(first);
+            while (run_end != last && (*run_end).index() == index) {
+                ++run_end;
+            }
+
+            dispatch<RunVisit<std::remove_reference_t<F>, It>, N>(
+                index, 
+                visitor, 
+                first, 
+                run_end);
+            first = run_end;
+        }
+    }
+
+    // Reorders [first, last) in place so that elements holding the same 
+    // alternative are adjacent, in alternative order, keeping their 
+    // relative order. A subsequent `visit_each(..., preserve_order)` 
+    // then dispatches once per alternative.
+    template<typename It>
+    auto group_by_alternative(It first, It last) -> void {
+        std::stable_sort(
+            first, 
+            last, 
+            [](auto const& a, auto const& b) { 
+                return a.index() < b.index(); 
+            });
+    }
+
+}
+#endif //VARIANT_VISIT_EACH_HPP_INCLUDED
@@ -0,0 +1,397 @@
+// Tests for the JSON example's parser. Each test runs once per scanner
+// this build has, so the SIMD and portable structural indexes are checked
+// against the same inputs.
+#include "json.hpp"
+#include "json_parse.hpp"
+#include "json_write.hpp"
+#include <cstdio>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define TO_STR_IMPL(x) #x
+#define TO_STR(x) TO_STR_IMPL(x)
+#define ENSURE(cond) \
+do { \
+    if (!(cond)) { \
+        throw std::logic_error { \
+            __FILE__ ", " TO_STR(__LINE__) \
+                ": Condition not met - " TO_STR(cond) \
+        }; \
+    } \
+} \
+while (false)
+
+#define ENSURE_THROWS(expr) \
+do { \
+    bool expression_threw = false; \
+    try { \
+        (expr); \
+    } \
+    catch (...) { expression_threw = true; } \
+    if (!expression_threw) { \
+        throw std::logic_error { \
+            __FILE__ ", " TO_STR(__LINE__) \
+                ": Expression expected to throw - " TO_STR(expr) \
+        }; \
+    } \
+} \
+while (false)
+
+template<typename Scanner>
+auto parse(std::string const& text) -> json::JsonValue {
+    return json::parse_with<Scanner>(text.data(), text.size());
+}
+
+auto number(json::JsonValue const& v) -> double {
+    return variant::get<json::JsonNumber>(v).value;
+}
+
+auto string(json::JsonValue const& v) -> std::string const& {
+    return variant::get<json::JsonString>(v).value;
+}
+
+auto array(json::JsonValue const& v) -> json::JsonArray const& {
+    return *variant::get<json::JsonArrayProxy>(v);
+}
+
+auto object(json::JsonValue const& v) -> json::JsonObject const& {
+    return *variant::get<json::JsonObjectProxy>(v);
+}
+
+template<typename Scanner>
+auto scalar_tests() {
+    ENSURE(number(parse<Scanner>("42")) == 42.0);
+    ENSURE(number(parse<Scanner>("-0.5")) == -0.5);
+    ENSURE(number(parse<Scanner>("  1e3 ")) == 1000.0);
+    ENSURE(number(parse<Scanner>("1.5E-2")) == 0.015);
+    ENSURE(number(parse<Scanner>("0.1")) == 0.1);
+    ENSURE(number(parse<Scanner>("123456789012345678901234")) ==
+        123456789012345678901234.0);
+    ENSURE(number(parse<Scanner>("2.2250738585072014e-308")) ==
+        2.2250738585072014e-308);
+    ENSURE(number(parse<Scanner>("1e-400")) == 0.0);
+
+    ENSURE(variant::get<json::JsonBool>(parse<Scanner>("true")).value);
+    ENSURE(!variant::get<json::JsonBool>(parse<Scanner>("false")).value);
+    ENSURE(variant::is_alternative<json::JsonNull>(parse<Scanner>("null")));
+
+    ENSURE(string(parse<Scanner>("\"hello\"")) == "hello");
+    ENSURE(string(parse<Scanner>("\"\"")).empty());
+}
+
+template<typename Scanner>
+auto escape_tests() {
+    ENSURE(string(parse<Scanner>(R"("a\"b\\c\/d\n\t")")) == "a\"b\\c/d\n\t");
+    ENSURE(string(parse<Scanner>(R"("\u00e9\u20ac")")) == "\xc3\xa9\xe2\x82\xac");
+    ENSURE(string(parse<Scanner>(R"("\ud83d\ude00")")) == "\xf0\x9f\x98\x80");
+
+    // Structural characters and escaped quotes inside strings, including
+    // across 64 byte block boundaries
+    auto const padding = std::string(60, ' ');
+    auto const doc = parse<Scanner>(
+        padding + R"(["{[,:]}", "\\\"", "x\\\\"])");
+    ENSURE(array(doc).values.size() == 3);
+    ENSURE(string(array(doc).values[0]) == "{[,:]}");
+    ENSURE(string(array(doc).values[1]) == "\\\"");
+    ENSURE(string(array(doc).values[2]) == "x\\\\");
+
+    std::string long_string(200, 'a');
+    long_string[63] = '\\';
+    long_string[64] = '"';
+    ENSURE(string(parse<Scanner>("\"" + long_string + "\"")) ==
+        std::string(63, 'a') + "\"" + std::string(135, 'a'));
+}
+
+template<typename Scanner>
+auto container_tests() {
+    auto const doc = parse<Scanner>(R"({
+        "name": "widget",
+        "tags": [1, 2.5, true, null, [], {}],
+        "nested": { "a": { "b": [ { "c": "d" } ] } }
+    })");
+
+    auto const& members = object(doc).members;
+    ENSURE(members.size() == 3);
+    ENSURE(string(members.at("name")) == "widget");
+
+    auto const& tags = array(members.at("tags")).values;
+    ENSURE(tags.size() == 6);
+    ENSURE(number(tags[1]) == 2.5);
+    ENSURE(array(tags[4]).values.empty());
+    ENSURE(object(tags[5]).members.empty());
+
+    auto const& nested = object(members.at("nested")).members;
+    auto const& b = array(object(nested.at("a")).members.at("b")).values;
+    ENSURE(string(object(b[0]).members.at("c")) == "d");
+
+    // Long documents span many blocks
+    std::string numbers = "[";
+    for (int i = 0; i < 1000; ++i) {
+        numbers += std::to_string(i) + (i == 999 ? "]" : ",");
+    }
+    auto const long_doc = parse<Scanner>(numbers);
+    auto const& values = array(long_doc).values;
+    ENSURE(values.size() == 1000);
+    ENSURE(number(values[999]) == 999.0);
+}
+
+template<typename Scanner>
+auto error_tests() {
+    ENSURE_THROWS(parse<Scanner>(""));
+    ENSURE_THROWS(parse<Scanner>("   "));
+    ENSURE_THROWS(parse<Scanner>("[1, 2"));
+    ENSURE_THROWS(parse<Scanner>("[1 2]"));
+    ENSURE_THROWS(parse<Scanner>("[1,]"));
+    ENSURE_THROWS(parse<Scanner>("{\"a\" 1}"));
+    ENSURE_THROWS(parse<Scanner>("{1: 2}"));
+    ENSURE_THROWS(parse<Scanner>("\"unterminated"));
+    ENSURE_THROWS(parse<Scanner>("\"tab\tinside\""));
+    ENSURE_THROWS(parse<Scanner>("\"\\x\""));
+    ENSURE_THROWS(parse<Scanner>("\"\\ud83d\""));
+    ENSURE_THROWS(parse<Scanner>("tru"));
+    ENSURE_THROWS(parse<Scanner>("truex"));
+    ENSURE_THROWS(parse<Scanner>("01"));
+    ENSURE_THROWS(parse<Scanner>("1."));
+    ENSURE_THROWS(parse<Scanner>("-"));
+    ENSURE_THROWS(parse<Scanner>("1e"));
+    ENSURE_THROWS(parse<Scanner>("1e400"));
+    ENSURE_THROWS(parse<Scanner>("-1.5e400"));
+    ENSURE_THROWS(parse<Scanner>("1 2"));
+    ENSURE_THROWS(parse<Scanner>("[] []"));
+    ENSURE_THROWS(parse<Scanner>(std::string(2000, '[')));
+
+    size_t offset = 0;
+    try {
+        parse<Scanner>("[1, 2 3]");
+    }
+    catch (json::ParseError const& e) {
+        offset = e.offset();
+    }
+    ENSURE(offset == 6);
+}
+
+template<typename Scanner>
+auto round_trip_tests() {
+    auto const doc = json::array({
+        json::number(1.0),
+        json::string("two"),
+        json::boolean(true),
+        json::null()
+    });
+
+    std::ostringstream out;
+    out << json::JsonValue { doc };
+
+    auto const parsed = parse<Scanner>(out.str());
+    std::ostringstream again;
+    again << parsed;
+    ENSURE(again.str() == out.str());
+}
+
+auto number_format_tests() {
+    auto const format = [](double v) {
+        char out[json::max_number_chars];
+        return std::string(out, json::format_number(v, out));
+    };
+
+    ENSURE(format(0.0) == "0");
+    ENSURE(format(-0.0) == "-0");
+    ENSURE(format(42.0) == "42");
+    ENSURE(format(-1234567.0) == "-1234567");
+    ENSURE(format(0.1) == "0.1");
+    ENSURE(format(-2.5) == "-2.5");
+    ENSURE(format(std::nan("")) == "null");
+    ENSURE(format(HUGE_VAL) == "null");
+
+    double const samples[] = {
+        1.0 / 3.0, 1e22, 9007199254740993.0, 5e-324, 1.7976931348623157e308,
+        2.2250738585072014e-308, 123.456e-7
+    };
+    for (auto v : samples) {
+        auto const text = format(v);
+        ENSURE(text.size() <= 24);
+        ENSURE(std::strtod(text.c_str(), nullptr) == v);
+    }
+}
+
+auto serialize_tests() {
+    ENSURE(json::serialize(json::string("plain")) == "\"plain\"");
+    ENSURE(json::serialize(json::string("a\"b\\c\n\t\x01")) ==
+        R"("a\"b\\c\n\t\u0001")");
+    ENSURE(json::serialize(json::boolean(false)) == "false");
+    ENSURE(json::serialize(json::null()) == "null");
+
+    // Escapes either side of, and inside, the 16 byte chunks
+    for (size_t at = 0; at < 40; ++at) {
+        std::string text(40, 'x');
+        text[at] = '"';
+        auto const expected =
+            "\"" + text.substr(0, at) + "\\\"" + text.substr(at + 1) + "\"";
+        ENSURE(json::serialize(json::string(text)) == expected);
+    }
+
+    auto const doc = json::JsonValue { json::array({
+        json::number(1.0),
+        json::array({ }),
+        json::object({ { "k", json::string("v") } }),
+        json::number(0.5)
+    }) };
+    ENSURE(json::serialize(doc) == R"([1,[],{"k":"v"},0.5])");
+}
+
+auto serialize_round_trip_tests() {
+    std::string text = "[";
+    for (int i = 0; i < 2000; ++i) {
+        text += R"({"id": )" + std::to_string(i) +
+                R"(, "x": )" + std::to_string(i / 7.0) +
+                R"(, "s": "tab\t\u00e9 \"q\"", "b": true, "n": null})";
+        text += i == 1999 ? "]" : ",";
+    }
+
+    auto const doc = json::parse(text);
+    auto const once = json::serialize(doc);
+    ENSURE(json::serialize(json::parse(once)) == once);
+
+    // Through a file, in chunks much smaller than the document
+    auto* file = std::tmpfile();
+    ENSURE(file != nullptr);
+    {
+        json::OutputBuffer out { file, 256 };
+        json::serialize(doc, out);
+        out.flush();
+    }
+
+    std::rewind(file);
+    std::string read_back;
+    char chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        read_back.append(chunk, n);
+    }
+    std::fclose(file);
+    ENSURE(read_back == once);
+}
+
+auto flat_map_tests() {
+    using Map = json::FlatMap<std::string, int>;
+
+    Map m;
+    ENSURE(m.empty());
+    ENSURE(m.try_emplace("b", 1).second);
+    ENSURE(m.try_emplace("a", 2).second);
+    ENSURE(!m.try_emplace("b", 3).second);
+    ENSURE(m.size() == 2);
+    ENSURE(m.at("b") == 1);
+    ENSURE(m.begin()->first == "b");
+    ENSURE(m.find("c") == m.end());
+    ENSURE_THROWS(m.at("c"));
+    m["c"] = 4;
+    ENSURE(m.count("c") == 1);
+
+    // Past the threshold, lookups go through the hashed index
+    Map big;
+    for (int i = 0; i < 100; ++i) {
+        big.try_emplace(std::to_string(i), i);
+        ENSURE(big.is_indexed() == (i >= 16));
+    }
+    for (int i = 0; i < 100; ++i) {
+        ENSURE(big.at(std::to_string(i)) == i);
+    }
+
+    int expected = 0;
+    for (auto const& member : big) {
+        ENSURE(member.second == expected++);
+    }
+
+    ENSURE(big.erase("50") == 1);
+    ENSURE(big.erase("50") == 0);
+    ENSURE(big.size() == 99);
+    ENSURE(big.find("50") == big.end());
+    ENSURE(big.at("51") == 51);
+    ENSURE((big.begin() + 50)->first == "51");
+
+    json::FlatMap<std::string, int, std::allocator<std::pair<std::string, int>>,
+        json::MemberOrder::Any> any { { "x", 1 }, { "y", 2 }, { "z", 3 } };
+    any.erase("x");
+    ENSURE(any.begin()->first == "z");
+    ENSURE(any.at("y") == 2);
+
+    // Copies and moves, both while inline and once on the heap
+    auto small_copy = m;
+    auto big_copy = big;
+    ENSURE(small_copy.at("a") == 2 && big_copy.at("99") == 99);
+    ENSURE(big_copy.is_indexed());
+
+    auto small_moved = std::move(small_copy);
+    auto big_moved = std::move(big_copy);
+    ENSURE(small_copy.empty() && big_copy.empty());
+    ENSURE(small_moved.at("c") == 4 && big_moved.at("0") == 0);
+
+    small_moved = big_moved;
+    ENSURE(small_moved.size() == 99 && small_moved.at("98") == 98);
+    big_moved = Map { { "only", 1 } };
+    ENSURE(big_moved.size() == 1 && !big_moved.is_indexed());
+}
+
+auto object_order_tests() {
+    auto const doc = json::parse(R"({"z": 1, "a": 2, "m": 3, "a": 4})");
+    auto const& members = object(doc).members;
+    ENSURE(members.size() == 3);
+    ENSURE(number(members.at("a")) == 2.0);
+    ENSURE(json::serialize(doc) == R"({"z":1,"a":2,"m":3})");
+}
+
+using TestFunc = void (*)();
+
+template<typename Scanner>
+auto scanner_tests() -> std::vector<TestFunc> {
+    return {
+        scalar_tests<Scanner>,
+        escape_tests<Scanner>,
+        container_tests<Scanner>,
+        error_tests<Scanner>,
+        round_trip_tests<Scanner>
+    };
+}
+
+auto main(int, char const**) -> int {
+
+    std::vector<TestFunc> tests = {
+        number_format_tests,
+        serialize_tests,
+        serialize_round_trip_tests,
+        flat_map_tests,
+        object_order_tests
+    };
+
+    auto const scalar = scanner_tests<json::ScalarScanner>();
+    tests.insert(tests.end(), scalar.begin(), scalar.end());
+#ifdef JSON_HAS_SSE2
+    auto const sse2 = scanner_tests<json::Sse2Scanner>();
+    tests.insert(tests.end(), sse2.begin(), sse2.end());
+#endif
+#ifdef JSON_HAS_AVX2
+    if (json::has_avx2()) {
+        auto const avx2 = scanner_tests<json::Avx2Scanner>();
+        tests.insert(tests.end(), avx2.begin(), avx2.end());
+    }
+#endif
+
+    bool all_passed = true;
+    for (auto&& f : tests) {
+        try {
+            f();
+        }
+        catch (std::exception const& e) {
+            all_passed = false;
+            std::cerr << e.what() << "\n";
+        }
+    }
+
+    return all_passed ? 0 : -1;
+}
@@ -0,0 +1,88 @@
+// Built with exceptions disabled, so this can't use the ENSURE_THROWS 
+// machinery in variant_tests.cpp. Failures are reported and counted 
+// instead of thrown.
+#include "variant/variant.hpp"
+#include "variant/variant_vector.hpp"
+#include <cstdio>
+#include <string>
+
+#ifndef VARIANT_NO_EXCEPTIONS
+#error "VARIANT_NO_EXCEPTIONS should be defined when exceptions are disabled"
+#endif
+
+namespace {
+    int failures = 0;
+}
+
+#define TO_STR_IMPL(x) #x
+#define TO_STR(x) TO_STR_IMPL(x)
+#define ENSURE(cond) \
+do { \
+    if (!(cond)) { \
+        std::fprintf(stderr, "%s\n", \
+            __FILE__ ", " TO_STR(__LINE__) \
+                ": Condition not met - " TO_STR(cond)); \
+        ++failures; \
+    } \
+} \
+while (false)
+
+auto construct_and_visit_tests() {
+    using MyVariant = variant::Variant<int, std::string>;
+
+    MyVariant v { std::string { "Hello" } };
+    auto length = v.visit(
+        [](auto const& val) -> size_t { return sizeof(val); });
+    ENSURE(length == sizeof(std::string));
+
+    v = 42;
+    ENSURE(variant::is_alternative<int>(v));
+    ENSURE(variant::get<int>(v) == 42);
+}
+
+auto get_if_tests() {
+    using MyVariant = variant::Variant<int, std::string>;
+
+    MyVariant v { 42 };
+    ENSURE(variant::get_if<std::string>(&v) == nullptr);
+    ENSURE(variant::get_if<1>(&v) == nullptr);
+
+    auto* i = variant::get_if<int>(&v);
+    ENSURE(i != nullptr && *i == 42);
+}
+
+auto unsafe_get_tests() {
+    using MyVariant = variant::Variant<int, std::string>;
+
+    MyVariant v { std::string { "Hello" } };
+    ENSURE(variant::unsafe_get<1>(v) == "Hello");
+    ENSURE(variant::unsafe_get<std::string>(v).size() == 5);
+}
+
+auto variant_vector_tests() {
+    variant::VariantVector<int, std::string> v;
+    v.reserve(2);
+    v.push_back(1);
+    v.emplace_back<std::string>(3u, 'x');
+    ENSURE(v.size() == 2);
+    ENSURE(v[1].get<std::string>() == "xxx");
+    ENSURE(v.pool<int>().size() == 1);
+}
+
+using TestFunc = void (*)();
+
+auto main(int, char const**) -> int {
+
+    TestFunc tests[] = {
+        construct_and_visit_tests,
+        get_if_tests,
+        unsafe_get_tests,
+        variant_vector_tests
+    };
+
+    for (auto&& f : tests) {
+        f();
+    }
+
+    return failures == 0 ? 0 : -1;
+}
@@ -1,7 +1,23 @@
 #include "variant/variant.hpp"
+#include "variant/atomic.hpp"
+#include "variant/instrumentation.hpp"
+#include "variant/variant_vector.hpp"
+#include "variant/visit_each.hpp"
+#include "variant/parallel.hpp"
+#include "variant/recursive.hpp"
+#include "variant/serialize.hpp"
+#include "variant/view.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <sstream>
 #include <string>
 #include <stdexcept>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include <iostream>
 
 #define TO_STR_IMPL(x) #x
@@ -70,6 +86,122 @@ auto operator<<(std::ostream& os, A const&) -> std::ostream& {
 static_assert(!std::is_copy_constructible<A>::value,
     "Type `A` shouldn't be copy constructible");
 
+static_assert(std::is_same<variant::index_type_t<2>, std::uint8_t>::value,
+    "2 alternatives should be discriminated by a single byte");
+static_assert(std::is_same<variant::index_type_t<255>, std::uint8_t>::value,
+    "255 alternatives should be discriminated by a single byte");
+static_assert(std::is_same<variant::index_type_t<256>, std::uint16_t>::value,
+    "256 alternatives should need a two byte discriminator");
+
+static_assert(
+    std::is_same<variant::type_at_index_t<2, int, char, float>, float>::value,
+    "type_at_index_t should pick out the alternative at the index");
+static_assert(variant::type_index_of<0, char, int, char, char>::value == 1,
+    "type_index_of should find the first matching alternative");
+static_assert(variant::type_index_of<3, float, int, float>::value == 4,
+    "type_index_of should offset the index by N");
+static_assert(!variant::all_copy_constructible<int, A>::value,
+    "A variant holding an `A` shouldn't be copy constructible");
+static_assert(variant::all_noexcept_move_constructible<>::value,
+    "The traits should hold for an empty list");
+
+struct Pod {
+    int a;
+    double b;
+};
+
+static_assert(
+    std::is_trivially_copyable<variant::Variant<int, double, Pod>>::value,
+    "Variant of trivially copyable types should be trivially copyable");
+static_assert(
+    std::is_trivially_destructible<variant::Variant<int, double, Pod>>::value,
+    "Variant of trivially destructible types should be trivially destructible");
+static_assert(
+    !std::is_trivially_copyable<variant::Variant<int, std::string>>::value,
+    "Variant holding a std::string can't be trivially copyable");
+static_assert(
+    !std::is_trivially_destructible<variant::Variant<int, std::string>>::value,
+    "Variant holding a std::string can't be trivially destructible");
+static_assert(
+    std::is_copy_constructible<variant::Variant<int, std::string>>::value,
+    "Non-trivial Variant should still be copy constructible");
+
+static_assert(sizeof(variant::Variant<int, float>) == 8,
+    "Discriminator should pack into the payload's tail padding");
+static_assert(sizeof(variant::Variant<char, bool>) == 2,
+    "Discriminator should add a single byte");
+static_assert(sizeof(variant::Variant<short, char>) == 4,
+    "Discriminator should add a single byte");
+static_assert(sizeof(variant::Variant<double, int>) == 16,
+    "Variant should be no larger than its payload plus alignment");
+static_assert(
+    sizeof(variant::Variant<int, std::string>) == 
+        sizeof(std::string) + alignof(std::string),
+    "Variant should be no larger than its payload plus alignment");
+
+struct Point {
+    int x;
+    int y;
+};
+
+struct SumFields {
+    constexpr auto operator()(int i) const -> int { return i; }
+    constexpr auto operator()(char c) const -> int { return c - '0'; }
+    constexpr auto operator()(Point p) const -> int { return p.x + p.y; }
+};
+
+using Literal = variant::Variant<int, char, Point>;
+
+// Variants of trivially destructible types are literal types, so they can
+// be built, inspected and visited at compile time
+constexpr Literal literals[] = { 1, '2', Point { 3, 4 } };
+constexpr Literal literal_in_place { variant::in_place_index<2>, 5, 6 };
+constexpr Literal literal_copy = literals[1];
+
+constexpr auto sum_literals() -> int {
+    int total = 0;
+    for (auto const& l : literals) {
+        total += l.visit(SumFields { });
+    }
+
+    return total;
+}
+
+static_assert(literals[0].index() == 0, "Literal should hold an int");
+static_assert(literals[1].is_alternative<char>(), "Literal should hold a char");
+static_assert(variant::is_alternative<Point>(literals[2]), 
+    "Literal should hold a Point");
+static_assert(variant::get<int>(literals[0]) == 1, 
+    "get by type should work at compile time");
+static_assert(variant::get<2>(literals[2]).y == 4, 
+    "get by index should work at compile time");
+static_assert(variant::unsafe_get<char>(literal_copy) == '2', 
+    "Copies should keep their alternative");
+static_assert(variant::visit(SumFields { }, literal_in_place) == 11, 
+    "visit should work at compile time");
+static_assert(sum_literals() == 10, 
+    "visit should work in a constexpr function");
+
+template<size_t N>
+struct Constant { 
+    int value; 
+};
+
+struct ConstantValue {
+    template<size_t N>
+    constexpr auto operator()(Constant<N> c) const -> int { 
+        return c.value * static_cast<int>(N); 
+    }
+};
+
+using ManyConstants = variant::Variant<
+    Constant<0>, Constant<1>, Constant<2>, Constant<3>, Constant<4>,
+    Constant<5>, Constant<6>, Constant<7>, Constant<8>, Constant<9>>;
+
+static_assert(
+    ManyConstants { Constant<9> { 2 } }.visit(ConstantValue { }) == 18,
+    "Table dispatch should work at compile time");
+
 auto type_index_tests() {
 
     using MyVariant = variant::Variant<int, A, std::string>;
@@ -141,6 +273,140 @@ auto move_assign_tests() {
     ENSURE(42 == variant::get<int>(b));
 }
 
+auto trivial_copy_tests() {
+    using MyVariant = variant::Variant<int, double, Pod>;
+
+    MyVariant a { Pod { 1, 2.0 } };
+    MyVariant b { 42 };
+    std::memcpy(static_cast<void*>(&b), &a, sizeof(MyVariant));
+
+    ENSURE(variant::is_alternative<Pod>(b));
+    ENSURE(variant::get<Pod>(b).a == 1);
+    ENSURE(variant::get<Pod>(b).b == 2.0);
+
+    MyVariant c = b;
+    ENSURE(variant::get<Pod>(c).a == 1);
+
+    c = MyVariant { 3.5 };
+    ENSURE(variant::get<double>(c) == 3.5);
+}
+
+struct Message {
+    Message(int id, std::string body) :
+        id { id },
+        body { std::move(body) }
+    { }
+
+    Message(Message&& other) :
+        id { other.id },
+        body { std::move(other.body) }
+    {
+        ++moves;
+    }
+
+    Message(Message const&) = delete;
+
+    int id;
+    std::string body;
+
+    static int moves;
+};
+
+int Message::moves = 0;
+
+auto in_place_construct_tests() {
+    using MyVariant = variant::Variant<int, Message, std::string>;
+    using namespace std::literals;
+
+    Message::moves = 0;
+    MyVariant a { variant::in_place_type<Message>, 1, "Hello"s };
+    ENSURE(variant::is_alternative<Message>(a));
+    ENSURE(variant::get<Message>(a).body == "Hello");
+    ENSURE(Message::moves == 0);
+
+    MyVariant b { variant::in_place_index<2>, 3u, 'x' };
+    ENSURE(variant::get<std::string>(b) == "xxx");
+
+    MyVariant c { variant::in_place_index<0> };
+    ENSURE(variant::get<int>(c) == 0);
+}
+
+struct ThrowsOnConstruct {
+    explicit ThrowsOnConstruct(int) {
+        throw std::runtime_error { "ThrowsOnConstruct" };
+    }
+};
+
+auto throwing_construct_tests() {
+    using MyVariant = variant::Variant<std::string, ThrowsOnConstruct>;
+    ENSURE_THROWS((MyVariant { variant::in_place_type<ThrowsOnConstruct>, 1 }));
+}
+
+auto emplace_tests() {
+    using MyVariant = variant::Variant<int, Message, std::string>;
+    using namespace std::literals;
+
+    Message::moves = 0;
+    MyVariant v { 42 };
+
+    // Built in place even though the constructor may throw
+    ENSURE((!std::is_nothrow_constructible<Message, int, std::string>::value));
+    auto& m = v.emplace<Message>(7, "World"s);
+    ENSURE(&m == &variant::get<Message>(v));
+    ENSURE(m.id == 7);
+    ENSURE(Message::moves == 0);
+
+    auto& s = v.emplace<2>("Hello, World"s);
+    ENSURE(variant::is_alternative<std::string>(v));
+    ENSURE(&s == &variant::get<std::string>(v));
+
+    v.emplace<int>(5);
+    ENSURE(variant::get<int>(v) == 5);
+}
+
+auto same_alternative_assign_tests() {
+    using MyVariant = variant::Variant<int, std::string>;
+
+    std::string const long_string(100, 'a');
+    MyVariant v { long_string };
+    auto const* buffer = variant::get<std::string>(v).data();
+
+    std::string const shorter(50, 'b');
+    v = shorter;
+    ENSURE(variant::get<std::string>(v) == shorter);
+    ENSURE(variant::get<std::string>(v).data() == buffer);
+
+    MyVariant const other { std::string(60, 'c') };
+    v = other;
+    ENSURE(variant::get<std::string>(v) == std::string(60, 'c'));
+    ENSURE(variant::get<std::string>(v).data() == buffer);
+
+    auto const& self = v;
+    v = self;
+    ENSURE(variant::get<std::string>(v) == std::string(60, 'c'));
+
+    v = 42;
+    ENSURE(variant::get<int>(v) == 42);
+}
+
+auto forwarding_assign_tests() {
+    using MyVariant = variant::Variant<int, std::string>;
+
+    MyVariant v { 0 };
+    std::string s(100, 'a');
+    v = std::move(s);
+    ENSURE(variant::get<std::string>(v) == std::string(100, 'a'));
+    ENSURE(s.empty());
+
+    using MoveOnly = variant::Variant<int, A>;
+    bool destroyed = false;
+    MoveOnly m { 0 };
+    m = A { &destroyed };
+    ENSURE(variant::is_alternative<A>(m));
+    m = A { nullptr };
+    ENSURE(destroyed);
+}
+
 auto visit_tests() {
     using MyVariant = variant::Variant<int, A, std::string>;
 
@@ -155,6 +421,90 @@ auto visit_tests() {
     ENSURE(visited);
 }
 
+template<size_t N>
+struct Tag { size_t value = N; };
+
+auto table_visit_tests() {
+    using MyVariant = variant::Variant<
+        Tag<0>, Tag<1>, Tag<2>, Tag<3>, Tag<4>, Tag<5>, 
+        Tag<6>, Tag<7>, Tag<8>, Tag<9>, Tag<10>, Tag<11>>;
+
+    auto index_of = [](auto&& tag) { return tag.value; };
+
+    ENSURE(variant::visit(index_of, MyVariant { Tag<0> { } }) == 0);
+    ENSURE(variant::visit(index_of, MyVariant { Tag<7> { } }) == 7);
+    ENSURE(variant::visit(index_of, MyVariant { Tag<11> { } }) == 11);
+
+    MyVariant const v { Tag<9> { } };
+    ENSURE(variant::visit(index_of, v) == 9);
+}
+
+struct IndexPair {
+    template<size_t I, size_t J>
+    auto operator()(Tag<I> const&, Tag<J> const&) const {
+        return std::make_pair(I, J);
+    }
+};
+
+auto multi_visit_tests() {
+    using Small = variant::Variant<Tag<0>, Tag<1>, Tag<2>>;
+    using Large = variant::Variant<
+        Tag<0>, Tag<1>, Tag<2>, Tag<3>, Tag<4>, Tag<5>, 
+        Tag<6>, Tag<7>, Tag<8>, Tag<9>, Tag<10>, Tag<11>>;
+
+    Small const s { Tag<2> { } };
+    Large const l { Tag<10> { } };
+
+    auto const expected = std::make_pair(size_t { 2 }, size_t { 10 });
+    ENSURE(variant::visit(IndexPair { }, s, l) == expected);
+    ENSURE(variant::visit(IndexPair { }, l, s) == 
+        std::make_pair(expected.second, expected.first));
+
+    auto sum = variant::visit(
+        [](auto const& a, auto const& b, auto const& c) {
+            return a.value + b.value + c.value;
+        },
+        s, l, Small { Tag<1> { } });
+    ENSURE(sum == 13);
+}
+
+struct TakeString {
+    auto operator()(std::string&& s, int) const -> std::string {
+        return std::move(s);
+    }
+
+    template<typename T, typename U>
+    auto operator()(T&&, U&&) const -> std::string {
+        return { };
+    }
+};
+
+auto multi_visit_value_category_tests() {
+    using MyVariant = variant::Variant<int, std::string>;
+    using namespace std::literals;
+
+    MyVariant a { "Hello"s };
+    MyVariant b { 42 };
+
+    variant::visit(
+        [](auto& x, auto& y) {
+            ENSURE(!std::is_const<std::remove_reference_t<decltype(x)>>::value);
+            ENSURE(!std::is_const<std::remove_reference_t<decltype(y)>>::value);
+        },
+        a, b);
+
+    variant::visit(
+        [](auto&& x, auto&& y) {
+            ENSURE(std::is_rvalue_reference<decltype(x)>::value);
+            ENSURE(std::is_lvalue_reference<decltype(y)>::value);
+        },
+        std::move(a), b);
+
+    auto moved = variant::visit(
+        TakeString { }, MyVariant { "World"s }, MyVariant { 0 });
+    ENSURE(moved == "World");
+}
+
 auto access_tests() {
     using MyVariant = variant::Variant<int, A, std::string>;
     ENSURE(variant::get<int>(MyVariant { 42 }) == 42);
@@ -162,6 +512,1016 @@ auto access_tests() {
     ENSURE(std::is_rvalue_reference<decltype(variant::get<A>(std::declval<MyVariant>()))>::value);
 }
 
+auto get_if_tests() {
+    using MyVariant = variant::Variant<int, A, std::string>;
+
+    MyVariant v { 42 };
+    ENSURE(variant::get_if<int>(&v) != nullptr);
+    ENSURE(*variant::get_if<int>(&v) == 42);
+    ENSURE(variant::get_if<std::string>(&v) == nullptr);
+    ENSURE(variant::get_if<0>(&v) == &variant::get<int>(v));
+    ENSURE(variant::get_if<2>(&v) == nullptr);
+
+    MyVariant const& cv = v;
+    static_assert(
+        std::is_same<decltype(variant::get_if<int>(&cv)), int const*>::value,
+        "get_if on a const Variant should return a pointer to const");
+    ENSURE(*variant::get_if<0>(&cv) == 42);
+
+    MyVariant* none = nullptr;
+    ENSURE(variant::get_if<int>(none) == nullptr);
+    ENSURE(noexcept(variant::get_if<int>(&v)));
+}
+
+auto unsafe_get_tests() {
+    using namespace std::literals;
+    using MyVariant = variant::Variant<int, A, std::string>;
+
+    MyVariant v { "Hello"s };
+    ENSURE(variant::unsafe_get<std::string>(v) == "Hello");
+    ENSURE(&variant::unsafe_get<2>(v) == &variant::get<2>(v));
+
+    variant::unsafe_get<std::string>(v) += ", World";
+    ENSURE(variant::get<std::string>(v) == "Hello, World");
+
+    auto moved = variant::unsafe_get<2>(std::move(v));
+    ENSURE(moved == "Hello, World");
+}
+
+auto variant_vector_tests() {
+    using namespace std::literals;
+    using MyVector = variant::VariantVector<int, std::string, double>;
+
+    MyVector v;
+    ENSURE(v.empty());
+
+    v.push_back(1);
+    v.push_back("one"s);
+    v.emplace_back<double>(1.5);
+    v.emplace_back<1>(3u, 'x');
+    v.push_back(variant::Variant<int, std::string> { 2 });
+
+    ENSURE(v.size() == 5);
+    ENSURE(v[0].is_alternative<int>());
+    ENSURE(v[1].get<std::string>() == "one");
+    ENSURE(v[2].get<2>() == 1.5);
+    ENSURE(v[3].get<std::string>() == "xxx");
+    ENSURE(v[4].get<int>() == 2);
+    ENSURE(v[4].index() == 0);
+    ENSURE_THROWS(v[0].get<std::string>());
+
+    v[0].get<int>() = 10;
+    ENSURE(v[0].unsafe_get<0>() == 10);
+
+    auto length = v[1].visit(
+        [](auto const& val) { return sizeof(val); });
+    ENSURE(length == sizeof(std::string));
+
+    ENSURE(v.pool<int>().size() == 2);
+    ENSURE(v.pool<std::string>().size() == 2);
+    ENSURE(v.pool<2>().size() == 1);
+
+    std::string visited;
+    MyVector const& cv = v;
+    cv.visit_all(
+        [&visited](auto const& val) {
+            visited += std::to_string(sizeof(val)) + ",";
+        });
+    ENSURE(visited == "4,4," + std::to_string(sizeof(std::string)) + "," + 
+        std::to_string(sizeof(std::string)) + ",8,");
+
+    int sum = 0;
+    v.visit_all(
+        [&sum](auto& val) { 
+            sum += std::is_same<std::decay_t<decltype(val)>, int>::value; 
+        });
+    ENSURE(sum == 2);
+
+    v.clear();
+    ENSURE(v.empty());
+    ENSURE(v.pool<int>().empty());
+}
+
+auto variant_vector_throwing_tests() {
+    variant::VariantVector<int, ThrowsOnConstruct> v;
+    v.reserve(2);
+    v.push_back(1);
+    ENSURE_THROWS(v.emplace_back<ThrowsOnConstruct>(2));
+    ENSURE(v.size() == 1);
+    ENSURE(v[0].get<int>() == 1);
+
+    v.push_back(3);
+    ENSURE(v.size() == 2);
+    ENSURE(v[1].get<int>() == 3);
+}
+
+struct RecordVisit {
+    auto operator()(int i) -> void {
+        visited += "i" + std::to_string(i);
+    }
+
+    auto operator()(std::string const& s) -> void {
+        visited += "s" + s;
+    }
+
+    std::string& visited;
+};
+
+auto visit_each_tests() {
+    using namespace std::literals;
+    using MyVariant = variant::Variant<int, std::string>;
+
+    std::vector<MyVariant> values {
+        1, "a"s, 2, 3, "b"s, 4
+    };
+
+    std::string visited;
+    variant::visit_each(values.begin(), values.end(), RecordVisit { visited });
+    ENSURE(visited == "i1i2i3i4sasb");
+
+    visited.clear();
+    variant::visit_each(
+        values.cbegin(), 
+        values.cend(), 
+        RecordVisit { visited }, 
+        variant::preserve_order);
+    ENSURE(visited == "i1sai2i3sbi4");
+
+    variant::group_by_alternative(values.begin(), values.end());
+    visited.clear();
+    variant::visit_each(
+        values.begin(), 
+        values.end(), 
+        RecordVisit { visited }, 
+        variant::preserve_order);
+    ENSURE(visited == "i1i2i3i4sasb");
+
+    std::vector<MyVariant> empty;
+    variant::visit_each(empty.begin(), empty.end(), RecordVisit { visited });
+    variant::visit_each(
+        empty.begin(), 
+        empty.end(), 
+        RecordVisit { visited }, 
+        variant::preserve_order);
+}
+
+struct CountVisit {
+    template<typename T>
+    auto operator()(T const&) -> void {
+        ++local;
+        if (local == 1) {
+            ++chunks;
+        }
+        ++visited;
+    }
+
+    size_t local = 0;
+    std::atomic<size_t>& chunks;
+    std::atomic<size_t>& visited;
+};
+
+struct Length {
+    auto operator()(int i) const -> size_t {
+        return static_cast<size_t>(i);
+    }
+
+    auto operator()(std::string const& s) const -> size_t {
+        if (s == "throw") {
+            throw std::runtime_error { "Length" };
+        }
+        return s.size();
+    }
+};
+
+auto parallel_visit_each_tests() {
+    using MyVariant = variant::Variant<int, std::string>;
+
+    std::vector<MyVariant> values;
+    size_t expected = 0;
+    for (int i = 0; i < 10000; ++i) {
+        if (i % 3 == 0) {
+            values.push_back(std::string(static_cast<size_t>(i % 7), 'x'));
+            expected += static_cast<size_t>(i % 7);
+        }
+        else {
+            values.push_back(i);
+            expected += static_cast<size_t>(i);
+        }
+    }
+
+    variant::ThreadPool pool { 4 };
+    ENSURE(pool.concurrency() == 4);
+
+    // Each chunk sees a fresh copy of the visitor
+    std::atomic<size_t> chunks { 0 };
+    std::atomic<size_t> visited { 0 };
+    variant::parallel_visit_each(values, CountVisit { 0, chunks, visited }, pool);
+    ENSURE(visited == values.size());
+    ENSURE(chunks > 1);
+
+    auto total = variant::parallel_visit_reduce(
+        values, Length { }, size_t { 0 }, std::plus<size_t> { }, pool);
+    ENSURE(total == expected);
+
+    // Folding chunk results in range order keeps non-commutative 
+    // reductions deterministic
+    std::vector<variant::Variant<int, char>> digits;
+    std::string expected_digits;
+    for (int i = 0; i < 5000; ++i) {
+        digits.push_back(i % 10);
+        expected_digits += static_cast<char>('0' + i % 10);
+    }
+    auto concatenated = variant::parallel_visit_reduce(
+        digits,
+        [](auto v) { return std::string(1, static_cast<char>('0' + v)); },
+        std::string { },
+        [](std::string a, std::string const& b) { return a + b; },
+        pool);
+    ENSURE(concatenated == expected_digits);
+
+    std::vector<MyVariant> empty;
+    ENSURE(variant::parallel_visit_reduce(
+        empty, Length { }, size_t { 42 }, std::plus<size_t> { }, pool) == 42);
+
+    // A chunk can itself visit in parallel on the same pool, even when 
+    // every worker is busy with an outer chunk
+    variant::ThreadPool single { 0 };
+    ENSURE(single.concurrency() == 1);
+    for (auto* p : { &pool, &single }) {
+        std::atomic<size_t> inner { 0 };
+        variant::parallel_visit_each(
+            values,
+            [&](auto const&) {
+                std::atomic<size_t> unused { 0 };
+                if (inner < 8 * digits.size()) {
+                    variant::parallel_visit_each(
+                        digits, CountVisit { 0, unused, inner }, *p);
+                }
+            },
+            *p);
+        ENSURE(inner >= 8 * digits.size());
+    }
+
+    values[5000] = std::string { "throw" };
+    ENSURE_THROWS(variant::parallel_visit_reduce(
+        values, Length { }, size_t { 0 }, std::plus<size_t> { }, pool));
+}
+
+auto comparison_tests() {
+    using namespace std::literals;
+    using MyVariant = variant::Variant<int, std::string>;
+
+    ENSURE(MyVariant { 1 } == MyVariant { 1 });
+    ENSURE(MyVariant { 1 } != MyVariant { 2 });
+    ENSURE(MyVariant { "a"s } == MyVariant { "a"s });
+    ENSURE(MyVariant { "a"s } != MyVariant { "b"s });
+    ENSURE(MyVariant { 1 } != MyVariant { "1"s });
+
+    // Ordered by alternative first, then by value
+    ENSURE(MyVariant { 2 } < MyVariant { 3 });
+    ENSURE(MyVariant { 3 } < MyVariant { "a"s });
+    ENSURE(!(MyVariant { "a"s } < MyVariant { 3 }));
+    ENSURE(MyVariant { "b"s } > MyVariant { "a"s });
+    ENSURE(MyVariant { "a"s } <= MyVariant { "a"s });
+    ENSURE(MyVariant { "a"s } >= MyVariant { "a"s });
+
+    std::map<MyVariant, int> ordered {
+        { "b"s, 4 }, { 2, 2 }, { "a"s, 3 }, { 1, 1 }
+    };
+    int expected = 1;
+    for (auto const& p : ordered) {
+        ENSURE(p.second == expected++);
+    }
+
+    std::unordered_map<MyVariant, int> hashed {
+        { 1, 1 }, { "1"s, 2 }
+    };
+    ENSURE(hashed.at(1) == 1);
+    ENSURE(hashed.at("1"s) == 2);
+    ENSURE(hashed.count(2) == 0);
+
+    // Bytewise comparable alternatives compare and hash by their bytes,
+    // but equal values held as different alternatives still differ
+    using Integral = variant::Variant<char, int, long long, int const*>;
+    std::hash<Integral> hash;
+    ENSURE(Integral { 42 } == Integral { 42 });
+    ENSURE(Integral { 42 } != Integral { 43 });
+    ENSURE(Integral { 42 } != Integral { 42ll });
+    ENSURE(Integral { 'a' } == Integral { 'a' });
+    ENSURE(hash(Integral { 42 }) == hash(Integral { 42 }));
+    ENSURE(hash(Integral { 42 }) != hash(Integral { 42ll }));
+    ENSURE(Integral { -1 } < Integral { 1 });
+    ENSURE(Integral { 1 } < Integral { 0ll });
+
+    // The bytes a narrower alternative leaves unused don't take part
+    Integral reused { -1ll };
+    reused = 'a';
+    ENSURE(reused == Integral { 'a' });
+    ENSURE(hash(reused) == hash(Integral { 'a' }));
+    reused.emplace<int>(7);
+    ENSURE(reused == Integral { 7 });
+
+    int const x = 0;
+    ENSURE(Integral { &x } == Integral { &x });
+    ENSURE(Integral { &x } != Integral { static_cast<int const*>(nullptr) });
+}
+
+struct TreeNode;
+
+using Tree = variant::Variant<int, variant::recursive<TreeNode>>;
+
+struct TreeNode {
+    std::vector<Tree> children;
+};
+
+struct SumTree {
+    auto operator()(int i) const -> int { 
+        return i; 
+    }
+
+    auto operator()(TreeNode const& n) const -> int {
+        int total = 0;
+        for (auto const& c : n.children) {
+            total += c.visit(*this);
+        }
+        return total;
+    }
+};
+
+using ArenaTree = variant::Variant<
+    int, 
+    variant::recursive<struct ArenaNode, variant::ArenaAllocator<ArenaNode>>>;
+
+struct ArenaNode {
+    std::vector<ArenaTree, variant::ArenaAllocator<ArenaTree>> children;
+};
+
+auto recursive_tests() {
+    using Node = variant::recursive<TreeNode>;
+
+    Tree tree = Node { TreeNode { { 1, Node { TreeNode { { 2, 3 } } } } } };
+    ENSURE(tree.visit(SumTree { }) == 6);
+
+    // Copies are deep
+    Tree copy = tree;
+    variant::get<Node>(copy)->children[0] = 10;
+    ENSURE(copy.visit(SumTree { }) == 15);
+    ENSURE(tree.visit(SumTree { }) == 6);
+
+    // Moves only take the pointer
+    auto const* node = &*variant::get<Node>(tree);
+    Tree moved = std::move(tree);
+    ENSURE(&*variant::get<Node>(moved) == node);
+
+    ENSURE(sizeof(Node) == sizeof(TreeNode*));
+
+    variant::MonotonicArena arena { 256 };
+    {
+        using ArenaNodePtr = 
+            variant::recursive<ArenaNode, variant::ArenaAllocator<ArenaNode>>;
+
+        ArenaNodePtr on_heap { ArenaNode { } };
+        variant::ArenaScope scope { arena };
+        ArenaNodePtr root { ArenaNode { } };
+        ENSURE(root.get_allocator().arena() == &arena);
+
+        for (int i = 0; i < 100; ++i) {
+            root->children.push_back(ArenaNodePtr { ArenaNode { } });
+            variant::get<1>(root->children.back())->children.push_back(i);
+        }
+
+        // Blocks grow, so 100 nodes and their vectors need only a few
+        ENSURE(arena.block_count() > 1);
+        ENSURE(arena.block_count() < 10);
+
+        ArenaNodePtr copy_in_arena = root;
+        ENSURE(copy_in_arena.get_allocator() == root.get_allocator());
+
+        // Copy assignment keeps the target's allocator
+        on_heap = root;
+        ENSURE(on_heap.get_allocator().arena() == nullptr);
+        ENSURE(on_heap->children.size() == 100);
+    }
+
+    // Copy assignment threads the target's allocator into a value that
+    // takes one, so nothing copied is left in the source's arena
+    {
+        using Ints = std::vector<int, variant::ArenaAllocator<int>>;
+        using IntsPtr = variant::recursive<Ints, variant::ArenaAllocator<Ints>>;
+
+        IntsPtr target { Ints { } };
+        {
+            variant::MonotonicArena source_arena;
+            variant::ArenaScope scope { source_arena };
+            IntsPtr source { Ints { 1, 2, 3 } };
+            ENSURE(source->get_allocator().arena() == &source_arena);
+
+            target = source;
+            ENSURE(target->get_allocator().arena() == nullptr);
+        }
+        ENSURE((*target)[0] == 1 && target->size() == 3);
+    }
+
+    // Outside a scope, nodes come from the heap
+    variant::ArenaAllocator<int> heap;
+    ENSURE(heap.arena() == nullptr);
+    auto* p = heap.allocate(4);
+    heap.deallocate(p, 4);
+
+    arena.release();
+    ENSURE(arena.block_count() == 0);
+}
+
+struct Large {
+    explicit Large(int i) :
+        id { i },
+        payload { }
+    { }
+
+    int id;
+    char payload[256];
+};
+
+auto boxed_tests() {
+    // Boxing allocates, so building a boxed alternative may throw even
+    // when the value's own constructor can't
+    using BoxedDouble = variant::Variant<int, variant::boxed<double>>;
+    static_assert(!noexcept(BoxedDouble { variant::in_place_type<double>, 1.0 }),
+        "in_place_type construction of a boxed alternative may throw");
+    static_assert(
+        !noexcept(std::declval<BoxedDouble&>().emplace<double>(1.0)),
+        "emplace of a boxed alternative may throw");
+    static_assert(noexcept(BoxedDouble { variant::in_place_type<int>, 1 }),
+        "in_place_type construction of an unboxed int can't throw");
+
+    using Boxed = variant::Variant<int, variant::boxed<Large>, std::string>;
+    ENSURE(sizeof(Boxed) < sizeof(Large));
+
+    // The box doesn't show through the variant's interface
+    Boxed v = Large { 7 };
+    ENSURE(variant::is_alternative<Large>(v));
+    ENSURE(variant::get<Large>(v).id == 7);
+    ENSURE(variant::get<1>(v).id == 7);
+    ENSURE(variant::get_if<Large>(&v) == &variant::get<Large>(v));
+    ENSURE(v.visit([](auto const& val) { return sizeof(val); }) == 
+        sizeof(Large));
+
+    // Assigning to the active boxed alternative reuses its allocation
+    auto const* large = &variant::get<Large>(v);
+    v = Large { 8 };
+    ENSURE(&variant::get<Large>(v) == large);
+    ENSURE(variant::get<Large>(v).id == 8);
+
+    // Copies are deep; moves take the pointer
+    Boxed copy = v;
+    ENSURE(&variant::get<Large>(copy) != large);
+    ENSURE(variant::get<Large>(copy).id == 8);
+
+    Boxed moved = std::move(v);
+    ENSURE(&variant::get<Large>(moved) == large);
+
+    v = 3;
+    ENSURE(variant::get<int>(v) == 3);
+    copy = std::string { "unboxed" };
+    ENSURE(variant::get<std::string>(copy) == "unboxed");
+    copy = moved;
+    ENSURE(variant::get<Large>(copy).id == 8);
+
+    auto& emplaced = v.emplace<Large>(9);
+    ENSURE(emplaced.id == 9 && variant::get<Large>(v).id == 9);
+
+    // Boxed alternatives are destroyed with the variant
+    bool destroyed = false;
+    {
+        variant::Variant<int, variant::boxed<A>> a { A { &destroyed } };
+        ENSURE(variant::is_alternative<A>(a));
+        destroyed = false;
+    }
+    ENSURE(destroyed);
+
+    using Strings = variant::Variant<int, variant::boxed<std::string>>;
+    ENSURE(Strings { std::string { "x" } } == Strings { std::string { "x" } });
+    ENSURE(Strings { std::string { "x" } } != Strings { 1 });
+
+    // A moved-from box can be assigned to again
+    Strings from { std::string { "moved" } };
+    Strings to { std::move(from) };
+    from = std::string { "again" };
+    ENSURE(variant::get<std::string>(from) == "again");
+    ENSURE(variant::get<std::string>(to) == "moved");
+    from = to;
+    ENSURE(from == to);
+
+    using Compact = variant::CompactVariant<16, int, Large, double>;
+    ENSURE((std::is_same<
+        Compact, 
+        variant::Variant<int, variant::boxed<Large>, double>>::value));
+    ENSURE(sizeof(Compact) <= 16);
+}
+
+// A user type that plugs into serialization through `serializer`.
+struct Named {
+    std::string name;
+    int id;
+};
+
+namespace variant {
+    template<>
+    struct serializer<Named> {
+        static auto write(BinaryWriter& w, Named const& val) -> void {
+            w.write(val.name);
+            w.write(val.id);
+        }
+
+        static auto read(BinaryReader& r) -> Named {
+            auto name = r.read<std::string>();
+            return Named { std::move(name), r.read<int>() };
+        }
+    };
+}
+
+auto serialize_tests() {
+    using Record = variant::Variant<
+        char, double, Point, std::string, Named, variant::boxed<Large>>;
+
+    std::vector<Record> records = {
+        'x', 2.5, Point { 3, 4 }, std::string { "four" }, 
+        Named { "five", 5 }, Large { 6 }
+    };
+
+    variant::BinaryWriter w;
+    for (auto const& r : records) {
+        variant::serialize(w, r);
+    }
+    auto const bytes = w.release();
+    ENSURE(w.size() == 0);
+
+    // A char and its index take two bytes; the double is aligned after it
+    ENSURE(variant::serialize(Record { 'x' }).size() == 2);
+    ENSURE(bytes.size() > 2 + sizeof(double) + sizeof(Large));
+
+    variant::BinaryReader r { bytes };
+    for (auto const& expected : records) {
+        auto const actual = variant::deserialize<Record>(r);
+        ENSURE(actual.index() == expected.index());
+    }
+    ENSURE(r.empty());
+
+    r = variant::BinaryReader { bytes };
+    ENSURE(variant::get<char>(variant::deserialize<Record>(r)) == 'x');
+    ENSURE(variant::get<double>(variant::deserialize<Record>(r)) == 2.5);
+    ENSURE(variant::get<Point>(variant::deserialize<Record>(r)).y == 4);
+    ENSURE(variant::get<std::string>(variant::deserialize<Record>(r)) == 
+        "four");
+    auto const named = variant::deserialize<Record>(r);
+    ENSURE(variant::get<Named>(named).name == "five");
+    ENSURE(variant::get<Named>(named).id == 5);
+    ENSURE(variant::get<Large>(variant::deserialize<Record>(r)).id == 6);
+
+    // Nested variants are written through their own serializer
+    using Outer = variant::Variant<int, Record>;
+    auto const nested = variant::serialize(Outer { Record { 2.5 } });
+    r = variant::BinaryReader { nested };
+    ENSURE(variant::get<double>(
+        variant::get<Record>(variant::deserialize<Outer>(r))) == 2.5);
+}
+
+auto visit_serialized_tests() {
+    using Record = variant::Variant<int, Point, std::string>;
+    variant::BinaryWriter w;
+    variant::serialize(w, Record { Point { 1, 2 } });
+    variant::serialize(w, Record { std::string { "text" } });
+
+    // Trivially serializable payloads are referred to where they lie
+    variant::BinaryReader r { w };
+    auto const* begin = w.data();
+    auto const* end = begin + w.size();
+    auto in_buffer = [&](auto const& val) {
+        auto const* p = reinterpret_cast<unsigned char const*>(&val);
+        return p >= begin && p < end;
+    };
+    ENSURE(variant::visit_serialized<Record>(r, in_buffer));
+    ENSURE(!variant::visit_serialized<Record>(r, in_buffer));
+    ENSURE(r.empty());
+
+    r = variant::BinaryReader { w };
+    auto const size = variant::visit_serialized<Record>(r, [](auto const& val) {
+        return sizeof(val);
+    });
+    ENSURE(size == sizeof(Point));
+
+    // Reusing the writer zeroes the padding again
+    w.clear();
+    variant::serialize(w, Record { 1 });
+    ENSURE(w.size() == 2 * sizeof(int));
+    ENSURE(w.data()[1] == 0);
+}
+
+auto corrupt_input_tests() {
+    using Record = variant::Variant<int, std::string>;
+    auto bytes = variant::serialize(Record { std::string { "text" } });
+
+    auto truncated = bytes;
+    truncated.pop_back();
+    variant::BinaryReader r { truncated };
+    ENSURE_THROWS(variant::deserialize<Record>(r));
+
+    bytes[0] = 2;
+    r = variant::BinaryReader { bytes };
+    ENSURE_THROWS(variant::deserialize<Record>(r));
+
+    r = variant::BinaryReader { nullptr, 0 };
+    ENSURE_THROWS(variant::visit_serialized<Record>(r, [](auto const&) { }));
+}
+
+auto variant_view_tests() {
+    using Record = variant::Variant<char, double, Point>;
+    using View = variant::view_of_t<Record>;
+
+    variant::BinaryWriter packed;
+    variant::BinaryWriter prefixed;
+    for (Record const& r : { Record { 'a' }, Record { 1.5 }, 
+                             Record { Point { 2, 3 } }, Record { 'b' } }) {
+        variant::serialize(packed, r);
+        variant::serialize_prefixed(prefixed, r);
+    }
+
+    auto check = [](auto const& range, unsigned char const* data) {
+        std::vector<View> views(range.begin(), range.end());
+        ENSURE(views.size() == 4);
+
+        ENSURE(variant::is_alternative<char>(views[0]));
+        ENSURE(variant::get<char>(views[0]) == 'a');
+        ENSURE(views[1].get<1>() == 1.5);
+        ENSURE_THROWS(views[1].get<char>());
+        ENSURE(variant::get<Point>(views[2]).y == 3);
+        ENSURE(variant::unsafe_get<0>(views[3]) == 'b');
+        ENSURE(variant::visit([](auto const& val) { return sizeof(val); }, 
+                              views[2]) == sizeof(Point));
+
+        // Payloads are read where they lie
+        ENSURE(views[2].data() > data);
+        ENSURE(&views[2].get<Point>() == views[2].data());
+    };
+
+    check(variant::records<Record>(packed.data(), packed.size()), 
+          packed.data());
+    check(variant::prefixed_records<Record>(prefixed.data(), prefixed.size()), 
+          prefixed.data());
+
+    ENSURE(prefixed.size() > packed.size());
+    auto const empty = variant::records<Record>(nullptr, 0);
+    ENSURE(empty.begin() == empty.end());
+
+    auto const truncated = 
+        variant::records<Record>(packed.data(), packed.size() - 1);
+    ENSURE_THROWS(std::vector<View>(truncated.begin(), truncated.end()));
+
+    auto corrupt = packed.release();
+    corrupt[0] = 3;
+    ENSURE_THROWS(variant::records<Record>(corrupt.data(), corrupt.size())
+        .begin());
+}
+
+struct Idle { };
+
+struct Running {
+    int progress;
+};
+
+struct Failed {
+    int code;
+};
+
+// Padding between the members, which `AtomicVariant` mustn't compare
+struct Padded {
+    char c;
+    int i;
+};
+
+auto operator==(Idle, Idle) -> bool { return true; }
+
+auto operator==(Running lhs, Running rhs) -> bool {
+    return lhs.progress == rhs.progress;
+}
+
+auto operator==(Failed lhs, Failed rhs) -> bool {
+    return lhs.code == rhs.code;
+}
+
+auto operator==(Padded lhs, Padded rhs) -> bool {
+    return lhs.c == rhs.c && lhs.i == rhs.i;
+}
+
+template<variant::AtomicStrategy S, typename... Ts>
+auto check_atomic_variant(variant::Variant<Ts...> const& first,
+                          variant::Variant<Ts...> const& second) -> void
+{
+    using V = variant::Variant<Ts...>;
+    variant::BasicAtomicVariant<S, Ts...> a { first };
+    ENSURE(a.load() == first);
+
+    a.store(second);
+    ENSURE(a.load() == second);
+    ENSURE(a.exchange(first) == second);
+    ENSURE(a.load() == first);
+
+    V expected = second;
+    ENSURE(!a.compare_exchange_strong(expected, second));
+    ENSURE(expected == first);
+    ENSURE(a.compare_exchange_strong(expected, second));
+    ENSURE(a.load() == second);
+
+    // A freshly built `expected` matches whatever was left in its unused 
+    // bytes
+    alignas(V) unsigned char raw[sizeof(V)];
+    std::memset(raw, 0xa5, sizeof(raw));
+    auto* fresh = ::new (static_cast<void*>(raw)) V { second };
+    ENSURE(a.compare_exchange_strong(*fresh, first));
+    ENSURE(a.load() == first);
+}
+
+auto atomic_variant_tests() {
+    using State = variant::Variant<Idle, Running, Failed>;
+    using W = variant::AtomicStrategy;
+    ENSURE((variant::AtomicVariant<Idle, Running, Failed>::strategy == 
+        W::Word));
+    ENSURE((variant::AtomicVariant<char, double>::strategy != W::Word));
+    ENSURE((variant::AtomicVariant<char, Large>::strategy == W::SeqLock));
+
+    check_atomic_variant<W::Word>(State { Running { 1 } }, State { Idle { } });
+    check_atomic_variant<W::SeqLock>(State { Running { 1 } }, 
+                                     State { Failed { 2 } });
+
+    using Wide = variant::Variant<char, Padded, double>;
+    check_atomic_variant<W::SeqLock>(Wide { Padded { 'a', 1 } }, 
+                                     Wide { 'b' });
+#ifdef VARIANT_HAS_DOUBLE_WORD_CAS
+    check_atomic_variant<W::DoubleWord>(Wide { Padded { 'a', 1 } }, 
+                                        Wide { 'b' });
+#endif
+
+    // Concurrent increments through compare-exchange aren't lost
+    variant::AtomicVariant<Idle, Running, Failed> shared { State { Idle { } } };
+    auto work = [&shared] {
+        for (int i = 0; i < 1000; ++i) {
+            auto current = shared.load();
+            State next = Running { 1 };
+            do {
+                if (variant::is_alternative<Running>(current)) {
+                    next = Running { variant::get<Running>(current).progress + 1 };
+                }
+            } while (!shared.compare_exchange_weak(current, next));
+        }
+    };
+    std::thread a { work };
+    std::thread b { work };
+    a.join();
+    b.join();
+    ENSURE(variant::get<Running>(shared.load()).progress == 2000);
+}
+
+struct Gauge {
+    int value;
+};
+
+struct Label {
+    std::string text;
+};
+
+namespace variant {
+    template<>
+    struct variant_instrumentation<Gauge, Label> {
+        using type = CountingInstrumentation;
+    };
+
+    template<>
+    struct variant_instrumentation<Gauge, int> {
+        using type = CountingInstrumentation;
+    };
+}
+
+using Metric = variant::Variant<Gauge, Label>;
+
+static_assert(
+    std::is_trivially_copyable<variant::Variant<Gauge, double>>::value,
+    "Uninstrumented variants should keep their trivial copies");
+
+static_assert(
+    !std::is_trivially_copyable<variant::Variant<Gauge, int>>::value,
+    "Instrumented variants should see their copies");
+
+auto instrumentation_tests() {
+    auto const before = variant::instrumentation_stats<Metric>();
+    {
+        Metric a { Gauge { 1 } };
+        Metric b { a };
+        Metric c { std::move(b) };
+        c = Label { "label" };
+        a = c;
+        a.visit([](auto const&) { });
+        c.emplace<Gauge>(2);
+        variant::visit([](auto const&, auto const&) { }, a, c);
+
+        // Assigning to the active alternative builds nothing new
+        c = Gauge { 4 };
+        Metric d { Label { "d" } };
+        d = a;
+    }
+
+    std::thread worker { [] {
+        Metric m { Gauge { 3 } };
+        for (int i = 0; i < 10; ++i) {
+            m.visit([](auto const&) { });
+        }
+    } };
+    worker.join();
+
+    auto const after = variant::instrumentation_stats<Metric>();
+    ENSURE(after.alternatives.size() == 2);
+
+    auto const& g0 = before.alternatives[0];
+    auto const& g1 = after.alternatives[0];
+    ENSURE(g1.name == "Gauge");
+    ENSURE(g1.constructs - g0.constructs == 3);
+    ENSURE(g1.copies - g0.copies == 1);
+    ENSURE(g1.moves - g0.moves == 1);
+    ENSURE(g1.destroys - g0.destroys == 5);
+    ENSURE(g1.visits - g0.visits == 11);
+
+    auto const& t0 = before.alternatives[1];
+    auto const& t1 = after.alternatives[1];
+    ENSURE(t1.constructs - t0.constructs == 2);
+    ENSURE(t1.copies - t0.copies == 1);
+    ENSURE(t1.moves - t0.moves == 0);
+    ENSURE(t1.destroys - t0.destroys == 3);
+    ENSURE(t1.visits - t0.visits == 2);
+
+    std::ostringstream out;
+    variant::dump_instrumentation(out);
+    auto const csv = out.str();
+    ENSURE(csv.find("variant,alternative,constructs,") == 0);
+    ENSURE(csv.find("\"Gauge\"") != std::string::npos);
+    ENSURE(csv.find("\"Label\"") != std::string::npos);
+}
+
+namespace variant {
+    template<>
+    struct variant_visit_hints<Gauge, double, Label> {
+        using type = std::index_sequence<2, 0>;
+    };
+}
+
+struct Describe {
+    auto operator()(Gauge const& g) const -> std::string {
+        return "gauge " + std::to_string(g.value);
+    }
+
+    auto operator()(double) const -> std::string {
+        return "double";
+    }
+
+    auto operator()(Label const& l) const -> std::string {
+        return "label " + l.text;
+    }
+};
+
+auto visit_hinted_tests() {
+    using Hinted = variant::Variant<Gauge, double, Label>;
+    using Plain = variant::Variant<Gauge, Label, double>;
+
+    Hinted values[] = { Gauge { 1 }, 2.0, Label { "x" } };
+    std::string const expected[] = { "gauge 1", "double", "label x" };
+    for (size_t i = 0; i < 3; ++i) {
+        auto& v = values[i];
+        ENSURE(v.visit(Describe { }) == expected[i]);
+        ENSURE(v.visit_hinted<1>(Describe { }) == expected[i]);
+        ENSURE((v.visit_hinted<2, 1, 0>(Describe { }) == expected[i]));
+        ENSURE(v.visit_likely<Label>(Describe { }) == expected[i]);
+        ENSURE((variant::visit_likely<double, Gauge>(Describe { }, v) == 
+            expected[i]));
+        ENSURE(variant::visit_hinted<0>(Describe { }, v) == expected[i]);
+    }
+
+    Plain const plain { Label { "y" } };
+    ENSURE(plain.visit_likely<Label>(Describe { }) == "label y");
+    ENSURE(plain.visit_likely<Gauge>(Describe { }) == "label y");
+
+    Plain temporary { Label { "z" } };
+    ENSURE(std::move(temporary).visit_likely<Label>([](auto&& val) {
+        return std::is_rvalue_reference<decltype(val)>::value;
+    }));
+
+    variant::VariantStats stats { "Stats", { } };
+    stats.alternatives.resize(4);
+    stats.alternatives[0].visits = 5;
+    stats.alternatives[1].visits = 900;
+    stats.alternatives[2].visits = 0;
+    stats.alternatives[3].visits = 95;
+    ENSURE((variant::likely_alternatives(stats) == 
+        std::vector<size_t> { 1 }));
+    ENSURE((variant::likely_alternatives(stats, 0.95) == 
+        std::vector<size_t> { 1, 3 }));
+    ENSURE((variant::likely_alternatives(stats, 1.0) == 
+        std::vector<size_t> { 1, 3, 0 }));
+    ENSURE(variant::likely_alternatives(variant::VariantStats { }).empty());
+}
+
+// Copies throw while `fail` is set; moves can't throw.
+struct Fragile {
+    Fragile() = default;
+
+    Fragile(Fragile const&) {
+        if (fail) {
+            throw std::runtime_error { "Fragile" };
+        }
+    }
+
+    Fragile(Fragile&&) noexcept {
+        ++moves;
+    }
+
+    Fragile& operator=(Fragile const&) = default;
+    Fragile& operator=(Fragile&&) = default;
+
+    static bool fail;
+    static int moves;
+};
+
+bool Fragile::fail = false;
+int Fragile::moves = 0;
+
+namespace variant {
+    template<>
+    struct variant_assign_strategy<short, Fragile> 
+        : assign_strategy_t<AssignStrategy::Direct> 
+    { };
+
+    template<>
+    struct variant_assign_strategy<long, Fragile> 
+        : assign_strategy_t<AssignStrategy::DoubleBuffer> 
+    { };
+}
+
+template<typename V, typename T>
+auto check_assign_strategy(T initial, int expected_moves, bool strong) {
+    Fragile const fragile { };
+    V const other { fragile };
+
+    Fragile::fail = false;
+    Fragile::moves = 0;
+    V v { initial };
+    v = fragile;
+    ENSURE(variant::is_alternative<Fragile>(v));
+    ENSURE(Fragile::moves == expected_moves);
+
+    v = initial;
+    v = other;
+    ENSURE(variant::is_alternative<Fragile>(v));
+
+    v.template emplace<T>(initial);
+    ENSURE(variant::get<T>(v) == initial);
+
+    if (strong) {
+        Fragile::fail = true;
+        ENSURE_THROWS(v = fragile);
+        ENSURE(variant::get<T>(v) == initial);
+        ENSURE_THROWS(v = other);
+        ENSURE(variant::get<T>(v) == initial);
+        Fragile::fail = false;
+    }
+}
+
+auto assign_strategy_tests() {
+    using Temporary = variant::Variant<int, Fragile>;
+    using Direct = variant::Variant<short, Fragile>;
+    using DoubleBuffer = variant::Variant<long, Fragile>;
+
+    ENSURE((variant::variant_assign_strategy<int, Fragile>::value == 
+        variant::AssignStrategy::Temporary));
+    ENSURE(sizeof(DoubleBuffer) > sizeof(Temporary));
+
+    check_assign_strategy<Temporary>(1, 1, true);
+    check_assign_strategy<Direct>(short { 2 }, 0, false);
+    check_assign_strategy<DoubleBuffer>(3L, 0, true);
+
+    // Only double buffering keeps the old value when `emplace` throws
+    DoubleBuffer v { 4L };
+    Fragile const fragile { };
+    Fragile::fail = true;
+    ENSURE_THROWS(v.emplace<Fragile>(fragile));
+    ENSURE(variant::get<long>(v) == 4);
+    Fragile::fail = false;
+
+    // A value built in the spare buffer survives copies and moves
+    v.emplace<Fragile>(fragile);
+    auto copy = v;
+    auto moved = std::move(copy);
+    ENSURE(variant::is_alternative<Fragile>(moved));
+    moved = 5L;
+    ENSURE(variant::get<long>(moved) == 5);
+}
+
 auto noexcept_tests() {
     using MyVariant = variant::Variant<int, A, std::string>;
     using MyOtherVariant = variant::Variant<int, float>;
@@ -215,10 +1575,36 @@ auto main(int, char const**) -> int {
         noexcept_constructor_tests,
         copy_construct_tests,
         visit_tests,
+        table_visit_tests,
+        multi_visit_tests,
+        multi_visit_value_category_tests,
         access_tests,
+        get_if_tests,
+        comparison_tests,
+        variant_vector_tests,
+        variant_vector_throwing_tests,
+        visit_each_tests,
+        parallel_visit_each_tests,
+        recursive_tests,
+        boxed_tests,
+        serialize_tests,
+        visit_serialized_tests,
+        corrupt_input_tests,
+        variant_view_tests,
+        atomic_variant_tests,
+        instrumentation_tests,
+        visit_hinted_tests,
+        assign_strategy_tests,
+        unsafe_get_tests,
         noexcept_tests,
         copy_assign_tests,
+        trivial_copy_tests,
+        in_place_construct_tests,
+        throwing_construct_tests,
+        emplace_tests,
         move_assign_tests,
+        same_alternative_assign_tests,
+        forwarding_assign_tests,
         type_at_index_tests
     };
 